@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+
+/**
+ * @brief AsyncSink Class. JsonSink handing the filled buffers to a dedicated I/O thread, which writes them to
+ * the target sink. Serialization and writes overlap.
+ *
+ * Buffers are taken over (no copy) and recycled once written. At most (buffers - 1) filled buffers are queued:
+ * the serializing thread waits when the I/O thread lags behind.
+ */
+class BOOST_SYMBOL_EXPORT AsyncSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new Async Sink.
+   * @param target
+   * @param buffers Number of buffers in use (at least 2: double buffering).
+   */
+  explicit AsyncSink(JsonSink &target, size_t buffers = 3);
+  /**
+   * @brief Destroy the Async Sink. Queued buffers are written, errors are dropped (call flush()).
+   */
+  ~AsyncSink();
+
+  AsyncSink(const AsyncSink &) = delete;
+  AsyncSink &operator=(const AsyncSink &) = delete;
+
+  void write(std::string &buffer) override;
+  /**
+   * @brief Wait for the queued buffers to be written, then flush the target sink.
+   * Rethrows the first error raised by the I/O thread.
+   */
+  void flush() override;
+  /**
+   * @brief Wait for the queued buffers to be written, then finish the target sink.
+   * Rethrows the first error raised by the I/O thread.
+   */
+  void finish() override;
+  int precision() const override { return m_target.precision(); }
+  std::ios_base::fmtflags flags() const override { return m_target.flags(); }
+
+private:
+  void run();
+  /**
+   * @brief Wait for the queued buffers to be written, and rethrow the I/O thread error (if any).
+   */
+  void wait();
+
+  JsonSink &m_target;
+  size_t m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  /**
+   * @brief Filled buffers, waiting for the I/O thread.
+   */
+  std::deque<std::string> m_queue;
+  /**
+   * @brief Written buffers, ready to be reused.
+   */
+  std::vector<std::string> m_free;
+  bool m_busy = false;
+  bool m_stop = false;
+  std::exception_ptr m_error;
+  std::thread m_thread;
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+#include "boost/JsonSource.hpp"
+
+// Compressed sinks/sources, available when the library is built with zlib (BOOST_JSON_ARCHIVE_ZLIB) and/or
+// zstd (BOOST_JSON_ARCHIVE_ZSTD). They compress/decompress whole buffers at once, by large blocks.
+
+#ifdef BOOST_JSON_ARCHIVE_ZLIB
+
+/**
+ * @brief GzipSink Class. JsonSink compressing the written buffers (gzip format) into a target sink.
+ */
+class BOOST_SYMBOL_EXPORT GzipSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new Gzip Sink.
+   * @param target
+   * @param level zlib compression level (-1: default, 0-9).
+   */
+  explicit GzipSink(JsonSink &target, int level = -1);
+  ~GzipSink();
+
+  GzipSink(const GzipSink &) = delete;
+  GzipSink &operator=(const GzipSink &) = delete;
+
+  void write(std::string &buffer) override;
+  /**
+   * @brief Flush the compressed data written so far (sync flush), then flush the target sink.
+   */
+  void flush() override;
+  /**
+   * @brief End the gzip stream, then finish the target sink.
+   */
+  void finish() override;
+  int precision() const override { return m_target.precision(); }
+  std::ios_base::fmtflags flags() const override { return m_target.flags(); }
+
+private:
+  void encode(const char *data, size_t size, int mode);
+  void drain();
+
+  struct Stream;
+  JsonSink &m_target;
+  std::unique_ptr<Stream> m_stream;
+  std::string m_out;
+  size_t m_used = 0;
+};
+
+/**
+ * @brief GzipSource Class. JsonSource decompressing gzip (or zlib) data read from another source.
+ * Concatenated gzip members are read as one stream.
+ */
+class BOOST_SYMBOL_EXPORT GzipSource : public JsonSource {
+public:
+  /**
+   * @brief Construct a new Gzip Source.
+   * @param source
+   */
+  explicit GzipSource(JsonSource &source);
+  ~GzipSource();
+
+  GzipSource(const GzipSource &) = delete;
+  GzipSource &operator=(const GzipSource &) = delete;
+
+  size_t read(char *data, size_t size) override;
+
+private:
+  struct Stream;
+  JsonSource &m_source;
+  std::unique_ptr<Stream> m_stream;
+  std::string m_in;
+  bool m_end = false;
+  /**
+   * @brief No gzip member is partially read.
+   */
+  bool m_complete = true;
+};
+
+#endif // BOOST_JSON_ARCHIVE_ZLIB
+
+#ifdef BOOST_JSON_ARCHIVE_ZSTD
+
+/**
+ * @brief ZstdSink Class. JsonSink compressing the written buffers (zstd format) into a target sink.
+ */
+class BOOST_SYMBOL_EXPORT ZstdSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new Zstd Sink.
+   * @param target
+   * @param level zstd compression level (0: default).
+   */
+  explicit ZstdSink(JsonSink &target, int level = 0);
+  ~ZstdSink();
+
+  ZstdSink(const ZstdSink &) = delete;
+  ZstdSink &operator=(const ZstdSink &) = delete;
+
+  void write(std::string &buffer) override;
+  /**
+   * @brief Flush the compressed data written so far, then flush the target sink.
+   */
+  void flush() override;
+  /**
+   * @brief End the zstd frame, then finish the target sink.
+   */
+  void finish() override;
+  int precision() const override { return m_target.precision(); }
+  std::ios_base::fmtflags flags() const override { return m_target.flags(); }
+
+private:
+  void encode(const char *data, size_t size, int mode);
+  void drain();
+
+  struct Stream;
+  JsonSink &m_target;
+  std::unique_ptr<Stream> m_stream;
+  std::string m_out;
+  size_t m_used = 0;
+};
+
+/**
+ * @brief ZstdSource Class. JsonSource decompressing zstd data read from another source.
+ */
+class BOOST_SYMBOL_EXPORT ZstdSource : public JsonSource {
+public:
+  /**
+   * @brief Construct a new Zstd Source.
+   * @param source
+   */
+  explicit ZstdSource(JsonSource &source);
+  ~ZstdSource();
+
+  ZstdSource(const ZstdSource &) = delete;
+  ZstdSource &operator=(const ZstdSource &) = delete;
+
+  size_t read(char *data, size_t size) override;
+
+private:
+  struct Stream;
+  JsonSource &m_source;
+  std::unique_ptr<Stream> m_stream;
+  std::string m_in;
+  size_t m_inSize = 0;
+  size_t m_inPos = 0;
+  bool m_end = false;
+  /**
+   * @brief No zstd frame is partially read.
+   */
+  bool m_complete = true;
+};
+
+#endif // BOOST_JSON_ARCHIVE_ZSTD
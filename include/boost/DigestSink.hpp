@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+
+/**
+ * @brief DigestSink Class. JsonSink hashing the written bytes on the fly (XXH64, seed 0), then forwarding them to a
+ * target sink, or dropping them (digest only: nothing is produced).
+ *
+ * With a json_canonical archive, equal documents give equal digests: an unchanged snapshot is detected at
+ * serialization speed, without any I/O.
+ */
+class BOOST_SYMBOL_EXPORT DigestSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new Digest Sink, dropping the written bytes.
+   */
+  DigestSink() = default;
+  /**
+   * @brief Construct a new Digest Sink, forwarding the written bytes to a target sink.
+   * @param target
+   */
+  explicit DigestSink(JsonSink &target) : m_target{&target} {}
+
+  void write(std::string &buffer) override;
+  void flush() override;
+  void finish() override;
+  int precision() const override { return m_target ? m_target->precision() : JsonSink::precision(); }
+  std::ios_base::fmtflags flags() const override { return m_target ? m_target->flags() : JsonSink::flags(); }
+
+  /**
+   * @brief XXH64 digest of the bytes written so far.
+   * @return uint64_t
+   */
+  uint64_t digest() const;
+  /**
+   * @brief Number of bytes written so far.
+   * @return uint64_t
+   */
+  uint64_t size() const { return m_size; }
+  /**
+   * @brief Start a new digest (the target sink is kept).
+   */
+  void reset();
+
+  /**
+   * @brief XXH64 digest of a memory area.
+   * @param data
+   * @param size
+   * @return uint64_t
+   */
+  static uint64_t digest(const char *data, size_t size);
+
+private:
+  void update(const char *data, size_t size);
+
+  JsonSink *m_target = nullptr;
+  /**
+   * @brief Accumulators of the 32 bytes stripes.
+   */
+  uint64_t m_acc[4] = {};
+  /**
+   * @brief Bytes of an incomplete stripe.
+   */
+  char m_stripe[32];
+  size_t m_stripeSize = 0;
+  uint64_t m_size = 0;
+};
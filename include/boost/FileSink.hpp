@@ -0,0 +1,89 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+
+/**
+ * @brief FileSink Class. JsonSink writing to a file with positional vectored writes (pwritev), bypassing iostreams.
+ *
+ * Buffered mode: the written buffers are taken over (no copy) and written together, in a single pwritev,
+ * once bufferSize bytes are pending.
+ * Direct mode (O_DIRECT, Linux): output is copied into an aligned buffer of bufferSize bytes, written once full;
+ * the unaligned tail is written without O_DIRECT by finish().
+ */
+class BOOST_SYMBOL_EXPORT FileSink : public JsonSink {
+public:
+  /**
+   * @brief Number of bytes pending before a write.
+   */
+  static constexpr size_t DefaultBufferSize = 4 * 1024 * 1024;
+  /**
+   * @brief Alignment of the O_DIRECT writes (offsets, sizes and memory).
+   */
+  static constexpr size_t DirectAlignment = 4096;
+
+  /**
+   * @brief Construct a new File Sink. The file is created (or truncated).
+   * @param path
+   * @param sizeHint Expected size of the file, preallocated when not 0 (Linux).
+   * @param direct Use O_DIRECT writes when available (Linux).
+   * @param bufferSize Number of bytes pending before a write.
+   */
+  explicit FileSink(const std::string &path, uint64_t sizeHint = 0, bool direct = false,
+                    size_t bufferSize = DefaultBufferSize);
+  /**
+   * @brief Destroy the File Sink. Pending data is written, errors are dropped (call finish()).
+   */
+  ~FileSink();
+
+  FileSink(const FileSink &) = delete;
+  FileSink &operator=(const FileSink &) = delete;
+
+  void write(std::string &buffer) override;
+  /**
+   * @brief Write the pending data (Direct mode: the aligned part only).
+   */
+  void flush() override;
+  /**
+   * @brief Write all the pending data and close the file.
+   */
+  void finish() override;
+
+private:
+  /**
+   * @brief Write the given buffers at the current offset (all of them, retrying partial writes).
+   * @param buffers
+   * @param sizes
+   * @param count
+   */
+  void writeAll(const char *const *buffers, const size_t *sizes, size_t count);
+  void writePending();
+  void writeDirect(size_t size);
+
+  int m_fd = -1;
+  uint64_t m_offset = 0;
+  size_t m_bufferSize;
+  bool m_direct = false;
+  /**
+   * @brief Buffered mode: taken over buffers, waiting to be written.
+   */
+  std::vector<std::string> m_pending;
+  size_t m_pendingBytes = 0;
+  /**
+   * @brief Buffered mode: written buffers, ready to be reused.
+   */
+  std::vector<std::string> m_free;
+  /**
+   * @brief Direct mode: aligned buffer (m_alignedSize bytes used).
+   */
+  char *m_aligned = nullptr;
+  size_t m_alignedSize = 0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Boost
+#include <boost/json.hpp>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+#include "boost/JsonSource.hpp"
+
+/**
+ * @brief JsonCbor Class. CBOR (RFC 8949) encoding of boost::json::value trees, used by cbor_oarchive/cbor_iarchive.
+ *
+ * Numbers and strings are written without any text conversion; doubles are written as single precision floats when
+ * exact. Decoding accepts definite and indefinite lengths, half/single/double precision floats and tags (ignored);
+ * map keys must be text strings, byte strings are not supported. Integers are decoded with the kind the Json text
+ * parser would give (int64 whenever the value fits).
+ */
+class BOOST_SYMBOL_EXPORT JsonCbor {
+public:
+  /**
+   * @brief Encode a Json value.
+   * @param jv
+   * @return std::string
+   */
+  static std::string encode(const boost::json::value &jv);
+  /**
+   * @brief Encode a Json value into a sink.
+   * @param jv
+   * @param sink
+   */
+  static void write(const boost::json::value &jv, JsonSink &sink);
+  /**
+   * @brief Decode one CBOR data item. Throws if the data is not valid CBOR (or holds other data after the item).
+   * @param data
+   * @return boost::json::value
+   */
+  static boost::json::value decode(std::string_view data);
+  /**
+   * @brief Read a whole source and decode it.
+   * @param source
+   * @return boost::json::value
+   */
+  static boost::json::value read(JsonSource &source);
+};
@@ -2,8 +2,13 @@
 #pragma once
 
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <stack>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
 
 // Boost Archive JSON
 #include <boost/json.hpp>
@@ -12,6 +17,10 @@
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/string.hpp>
 
+#include "boost/JsonSnapshot.hpp"
+#include "boost/JsonSource.hpp"
+#include "boost/JsonWriter.hpp"
+
 #include <memory>
 #include <sstream>
 
@@ -20,15 +29,44 @@
 #endif
 
 namespace param {
-const std::string ClassNameType("class_name");
-const std::string VersionType("version");
-const std::string ItemVersionType("item_version");
-const std::string ObjectIdType("object_id");
-const std::string ObjectReferenceType("object_id_ref");
-const std::string ClassIdType("class_id");
-const std::string ClassIdOptionalType("class_id_opt");
-const std::string ClassIdReferenceType("class_id_ref");
-const std::string TrackingType("tracking");
+constexpr JsonKey ClassNameKey("class_name");
+constexpr JsonKey VersionKey("version");
+constexpr JsonKey ItemVersionKey("item_version");
+constexpr JsonKey ObjectIdKey("object_id");
+constexpr JsonKey ObjectReferenceKey("object_id_ref");
+constexpr JsonKey ClassIdKey("class_id");
+constexpr JsonKey ClassIdOptionalKey("class_id_opt");
+constexpr JsonKey ClassIdReferenceKey("class_id_ref");
+constexpr JsonKey TrackingKey("tracking");
+constexpr JsonKey ColumnsKey("columns");
+constexpr JsonKey ColumnValuesKey("values");
+constexpr JsonKey StringTableKey("string_table");
+constexpr JsonKey BitsKey("bits");
+constexpr JsonKey BitsSizeKey("size");
+
+/**
+ * @brief All metadata keys (pre-escaped by JsonWriter).
+ */
+constexpr JsonKey MetadataKeys[] = {ClassNameKey,       VersionKey,          ItemVersionKey,
+                                    ObjectIdKey,        ObjectReferenceKey,  ClassIdKey,
+                                    ClassIdOptionalKey, ClassIdReferenceKey, TrackingKey,
+                                    ColumnsKey,         ColumnValuesKey,     StringTableKey,
+                                    BitsKey,            BitsSizeKey};
+
+const std::string ClassNameType(ClassNameKey.name());
+const std::string VersionType(VersionKey.name());
+const std::string ItemVersionType(ItemVersionKey.name());
+const std::string ObjectIdType(ObjectIdKey.name());
+const std::string ObjectReferenceType(ObjectReferenceKey.name());
+const std::string ClassIdType(ClassIdKey.name());
+const std::string ClassIdOptionalType(ClassIdOptionalKey.name());
+const std::string ClassIdReferenceType(ClassIdReferenceKey.name());
+const std::string TrackingType(TrackingKey.name());
+const std::string ColumnsType(ColumnsKey.name());
+const std::string ColumnValuesType(ColumnValuesKey.name());
+const std::string StringTableType(StringTableKey.name());
+const std::string BitsType(BitsKey.name());
+const std::string BitsSizeType(BitsSizeKey.name());
 } // namespace param
 
 #ifdef __GNUG__
@@ -55,7 +93,7 @@ public:
    * @param json_value
    * @return T
    */
-  template <typename T> static T get(boost::json::value &json_value) {
+  template <typename T> static T get(const boost::json::value &json_value) {
     if constexpr (std::is_same<T, bool>::value) {
       return json_value.get_bool();
     } else if constexpr (std::is_integral<T>::value) {
@@ -66,19 +104,35 @@ public:
       }
     } else if constexpr (std::is_floating_point<T>::value) {
       return json_value.get_double();
-    } else if constexpr (std::is_same<T, std::string>::value) {
-      return json_value.get_string().c_str();
+    } else if constexpr (std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value) {
+      const boost::json::string &str = json_value.get_string();
+      return T(str.data(), str.size());
     }
     throw std::runtime_error("Non-handled Json type !");
   }
 
+  /**
+   * @brief Assign raw value to an existing target (strings reuse their capacity).
+   * @tparam T
+   * @param target
+   * @param json_value
+   */
+  template <typename T> static void assign(T &target, const boost::json::value &json_value) {
+    if constexpr (std::is_same<T, std::string>::value) {
+      const boost::json::string &str = json_value.get_string();
+      target.assign(str.data(), str.size());
+    } else {
+      target = get<T>(json_value);
+    }
+  }
+
   /**
    * @brief Emplace raw value depending on T type.
    * @tparam T
    * @param json_value
    * @return T
    */
-  template <typename T> static void emplace(boost::json::value &json_value, const T val) {
+  template <typename T> static void emplace(boost::json::value &json_value, const T &val) {
     if constexpr (std::is_same<T, bool>::value) {
       json_value.emplace_bool();
       json_value.get_bool() = val;
@@ -91,15 +145,211 @@ public:
     } else if constexpr (std::is_floating_point<T>::value) {
       json_value.emplace_double();
       json_value.get_double() = val;
-    } else if constexpr (std::is_same<T, std::string>::value) {
-      json_value.emplace_string();
-      json_value.get_string() = val;
+    } else if constexpr (std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value) {
+      json_value.emplace_string().assign(boost::json::string_view(val.data(), val.size()));
     } else {
       throw std::runtime_error("Non-handled Json type !");
     }
   }
 
+  /**
+   * @brief Convert an array of objects to its columnar form: {"columns":[keys...],"values":[[column values]...]}.
+   * Members missing from a row are stored as null: missing and null members are not told apart (both are loaded as
+   * missing members).
+   * @param rows
+   * @param columnar
+   * @return true if converted (every row is an object, with at least one member in all)
+   * @return false
+   */
+  static bool toColumns(const boost::json::array &rows, boost::json::value &columnar);
+  /**
+   * @brief Return true if the value is a columnar encoded array.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool isColumnar(const boost::json::value &value);
+  /**
+   * @brief Number of rows of a columnar encoded array. Throws if the columns are malformed (keys that are not strings,
+   * value columns of different lengths).
+   * @param columnar
+   * @return size_t
+   */
+  static size_t columnsRows(const boost::json::value &columnar);
+  /**
+   * @brief Keys of a columnar encoded array.
+   * @param columnar
+   * @return const boost::json::array&
+   */
+  static const boost::json::array &columnsKeys(const boost::json::value &columnar);
+  /**
+   * @brief Value columns of a columnar encoded array.
+   * @param columnar
+   * @return const boost::json::array&
+   */
+  static const boost::json::array &columnsValues(const boost::json::value &columnar);
+  /**
+   * @brief Member of one row of a columnar encoded array, read in place from its column (nullptr if missing or null).
+   * The lookup starts at the column following the previous match: members loaded in their saved order are found at
+   * the first comparison.
+   * @param keys
+   * @param values
+   * @param row
+   * @param key
+   * @param cursor Column following the previous match (updated).
+   * @return const boost::json::value*
+   */
+  static const boost::json::value *columnsMember(const boost::json::array &keys, const boost::json::array &values,
+                                                 size_t row, boost::json::string_view key, size_t &cursor);
+
+  /**
+   * @brief Return true if the value (recursively) holds class information written by boost::archive
+   * (class ids/names, object ids). Version and tracking are only written next to a class id: user members with
+   * these names are not taken for class information.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool hasMetadata(const boost::json::value &value);
+  /**
+   * @brief Return true if one row of a columnar encoded array holds class information (see above).
+   * @param keys
+   * @param values
+   * @param row
+   * @return true
+   * @return false
+   */
+  static bool hasMetadata(const boost::json::array &keys, const boost::json::array &values, size_t row);
+  /**
+   * @brief Return true if the value (recursively) holds tracked objects or pointers (object ids, class references,
+   * tracking enabled), numbered by the archive that wrote them.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool hasTracking(const boost::json::value &value);
+  /**
+   * @brief Return true if the value (recursively) holds class ids or names, written by boost::archive with the first
+   * object of each class.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool hasClassInfo(const boost::json::value &value);
+  /**
+   * @brief Return true if the value (recursively) holds pointers or object references, whose class and object ids
+   * are numbered by the archive that wrote them.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool hasReferences(const boost::json::value &value);
+  /**
+   * @brief Pack bools into {"size":N,"bits":"<base64>"} (bit i is bit i%8 of byte i/8).
+   * @tparam C Container of bools: std::vector<bool> (gathered 64 bits at a time) or contiguous bools (gathered 8 at
+   * a time by a multiplication).
+   * @param bools
+   * @param packed
+   */
+  template <typename C> static void packBits(const C &bools, boost::json::value &packed) {
+    const size_t size = std::size(bools);
+    std::vector<uint8_t> bytes((size + 7) / 8);
+    if constexpr (std::is_same<C, std::vector<bool>>::value) {
+      uint64_t word = 0;
+      size_t i = 0;
+      for (bool b : bools) {
+        word |= uint64_t(b) << (i & 63);
+        if ((++i & 63) == 0) {
+          storeWord(bytes.data() + (i / 8) - 8, word, 8);
+          word = 0;
+        }
+      }
+      if (i & 63) {
+        storeWord(bytes.data() + (i & ~size_t(63)) / 8, word, bytes.size() - (i & ~size_t(63)) / 8);
+      }
+    } else {
+      const bool *data = std::data(bools);
+      size_t i = 0;
+      for (; i + 8 <= size; i += 8) {
+        // One 0/1 byte per bool: the multiplication moves byte j to bit 56 + j.
+        bytes[i / 8] = static_cast<uint8_t>((loadBools(data + i) * 0x0102040810204080ULL) >> 56);
+      }
+      for (; i < size; i++) {
+        bytes[i / 8] |= static_cast<uint8_t>(uint8_t(data[i]) << (i & 7));
+      }
+    }
+    boost::json::object &o = packed.emplace_object();
+    o[param::BitsSizeType] = size;
+    o[param::BitsType] = base64Encode(bytes);
+  }
+  /**
+   * @brief Return true if the value holds packed bools.
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool isPackedBits(const boost::json::value &value);
+  /**
+   * @brief Number of bools packed with packBits.
+   * @param packed
+   * @return size_t
+   */
+  static size_t packedBitsSize(const boost::json::value &packed);
+  /**
+   * @brief Unpack the first count bools packed with packBits straight into their target, 64 bits at a time.
+   * @tparam It Output iterator (std::vector<bool> iterator or bool pointer).
+   * @param packed
+   * @param out
+   * @param count
+   */
+  template <typename It> static void unpackBits(const boost::json::value &packed, It out, size_t count) {
+    const std::vector<uint8_t> bytes = packedBytes(packed, count);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+      const uint64_t word = loadWord(bytes.data() + i / 8, 8);
+      for (size_t j = 0; j < 64; j++) {
+        *out++ = (word >> j) & 1;
+      }
+    }
+    if (i < count) {
+      const uint64_t word = loadWord(bytes.data() + i / 8, (count - i + 7) / 8);
+      for (size_t j = 0; i + j < count; j++) {
+        *out++ = (word >> j) & 1;
+      }
+    }
+  }
+  /**
+   * @brief Return true if the value holds an array (plain Json array, columnar or packed bools).
+   * @param value
+   * @return true
+   * @return false
+   */
+  static bool isArray(const boost::json::value &value) { return value.is_array() || isColumnar(value) || isPackedBits(value); }
+
 private:
+  static void storeWord(uint8_t *dst, uint64_t word, size_t bytes) {
+    for (size_t b = 0; b < bytes; b++) {
+      dst[b] = static_cast<uint8_t>(word >> (8 * b));
+    }
+  }
+  static uint64_t loadWord(const uint8_t *src, size_t bytes) {
+    uint64_t word = 0;
+    for (size_t b = 0; b < bytes; b++) {
+      word |= uint64_t(src[b]) << (8 * b);
+    }
+    return word;
+  }
+  static uint64_t loadBools(const bool *src) {
+    uint64_t word = 0;
+    for (size_t b = 0; b < 8; b++) {
+      word |= uint64_t(src[b]) << (8 * b);
+    }
+    return word;
+  }
+  static std::vector<uint8_t> packedBytes(const boost::json::value &packed, size_t count);
+  static std::string base64Encode(const std::vector<uint8_t> &bytes);
+  static std::vector<uint8_t> base64Decode(boost::json::string_view str);
+
   /**
    * @brief Json Stack context.
    */
@@ -116,10 +366,22 @@ private:
    * @brief Currently handled tag (can differe from m_current.first).
    */
   std::string m_current_tag;
+  /**
+   * @brief Interned strings index (output).
+   */
+  std::unordered_map<std::string, uint64_t> m_string_index;
+  /**
+   * @brief Interned strings table (output).
+   */
+  boost::json::array m_string_table;
+  /**
+   * @brief Strings table used to resolve references (input).
+   */
+  const boost::json::array *m_string_refs = nullptr;
 
 public:
   /**
-   * @brief Parse Input Stream to Json.
+   * @brief Parse Input Stream to Json (Json text, or JsonSnapshot).
    * @param is
    * @param ec
    * @param sp
@@ -128,8 +390,11 @@ public:
    */
   static boost::json::value parse(std::istream &is, boost::system::error_code &ec, boost::json::storage_ptr sp = {},
                                   boost::json::parse_options const &opt = {}) {
+    std::string s(std::istreambuf_iterator<char>(is), {});
+    if (JsonSnapshot::isSnapshot(s)) {
+      return decodeSnapshot(s, ec, std::move(sp));
+    }
     try {
-      std::string s(std::istreambuf_iterator<char>(is), {});
       boost::json::value jv = boost::json::parse(s, ec, sp, opt);
       return jv;
     } catch (std::exception const &e) {
@@ -140,6 +405,42 @@ public:
     return {};
   }
 
+  /**
+   * @brief Decode a JsonSnapshot, reporting an invalid snapshot in ec (as a parse error) instead of throwing.
+   * @param data
+   * @param ec
+   * @param sp
+   * @return boost::json::value
+   */
+  static boost::json::value decodeSnapshot(std::string_view data, boost::system::error_code &ec,
+                                           boost::json::storage_ptr sp = {});
+
+  /**
+   * @brief Parse a Json source, block by block (the input is never held as a whole, except a JsonSnapshot).
+   * @param source
+   * @param ec
+   * @param sp
+   * @param opt
+   * @return boost::json::value
+   */
+  static boost::json::value parse(JsonSource &source, boost::system::error_code &ec, boost::json::storage_ptr sp = {},
+                                  boost::json::parse_options const &opt = {});
+
+  /**
+   * @brief Parse only the value located by a Json pointer, skipping the other values at tokenizer speed (no Json
+   * value is built for them, and they are not validated).
+   * The projection is an object holding the found value, named after the last pointer token, and the root strings
+   * table (if any): {"<last token>":value,"string_table":[...]}.
+   * Throws if the pointer is invalid (or empty), or if the keys along the pointer or the pointed value are not valid
+   * Json. Invalid Json outside them (skipped values, text after the pointed value) is not detected.
+   * @param source
+   * @param pointer
+   * @param projection
+   * @return true if the value was found
+   * @return false
+   */
+  static bool project(JsonSource &source, const std::string &pointer, boost::json::value &projection);
+
   /**
    * @brief Construct a new Json Context.
    * @param m_root
@@ -209,6 +510,39 @@ public:
    * @return std::string
    */
   std::string currentTag();
+  /**
+   * @brief Intern a string into the strings table.
+   * @param str
+   * @return uint64_t Index of the string in the table.
+   */
+  uint64_t intern(const std::string &str);
+  /**
+   * @brief Set the strings table used to resolve string references.
+   * @param table
+   */
+  void setStringTable(const boost::json::array *table);
+  /**
+   * @brief Strings table used to resolve string references.
+   * @return const boost::json::array* (nullptr when there is none)
+   */
+  const boost::json::array *stringTable() const { return m_string_refs; }
+  /**
+   * @brief Resolve a string reference (index in the strings table) to the referenced string value.
+   * Values are returned as is when there is no strings table.
+   * @param value
+   * @return const boost::json::value&
+   */
+  const boost::json::value &resolve(const boost::json::value &value) const;
+  /**
+   * @brief Complete Json document: the root, with the strings table attached (if any).
+   * @return const boost::json::value&
+   */
+  const boost::json::value &document();
+  /**
+   * @brief Move the complete Json document out (see document()), leaving an empty root.
+   * @return boost::json::value
+   */
+  boost::json::value takeDocument();
   /**
    * @brief Serialize root as Json to output stream.
    * @param os
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+
+// Boost
+#include <boost/json.hpp>
+
+// Boost Archive JSON
+#include "boost/JsonSource.hpp"
+
+/**
+ * @brief JsonDocument Class. Immutable parsed Json document, shared by json_iarchive views
+ * (json_iarchive(std::shared_ptr<const JsonDocument>, pointer, flags)).
+ *
+ * The document is parsed once and never modified afterwards: any number of threads can load from it at the same time,
+ * each one with its own archive.
+ */
+class BOOST_SYMBOL_EXPORT JsonDocument {
+public:
+  /**
+   * @brief Parse an input stream. Throws if the input is not Json.
+   * @param is
+   * @return std::shared_ptr<const JsonDocument>
+   */
+  static std::shared_ptr<const JsonDocument> parse(std::istream &is);
+  /**
+   * @brief Parse a source, block by block. Throws if the input is not Json.
+   * @param source
+   * @return std::shared_ptr<const JsonDocument>
+   */
+  static std::shared_ptr<const JsonDocument> parse(JsonSource &source);
+
+  /**
+   * @brief Construct a new Json Document.
+   * @param root Must use the default storage (the document is read concurrently).
+   */
+  explicit JsonDocument(boost::json::value &&root);
+
+  JsonDocument(const JsonDocument &) = delete;
+  JsonDocument &operator=(const JsonDocument &) = delete;
+
+  /**
+   * @brief Root value of the document.
+   * @return const boost::json::value&
+   */
+  const boost::json::value &root() const { return m_root; }
+  /**
+   * @brief Find a value from its Json pointer ("" is the root, "/config/network" a subtree...).
+   * @param pointer
+   * @return const boost::json::value* (nullptr when not found)
+   */
+  const boost::json::value *find(const std::string &pointer) const;
+  /**
+   * @brief Strings table of the document (json_string_table flag).
+   * @return const boost::json::array* (nullptr when there is none)
+   */
+  const boost::json::array *stringTable() const { return m_string_table; }
+
+private:
+  boost::json::value m_root;
+  const boost::json::array *m_string_table = nullptr;
+};
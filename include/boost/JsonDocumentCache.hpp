@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Boost Archive JSON
+#include "boost/JsonDocument.hpp"
+
+/**
+ * @brief JsonDocumentCache Class. Parsed documents of files (Json text or JsonSnapshot), keyed by path and checked
+ * against the file size and modification time: a file is parsed again only once it changed.
+ *
+ * Documents are immutable and shared (see JsonDocument): the same one can be loaded by any number of json_iarchive
+ * at the same time. The least recently used documents are dropped from the cache once the memory budget is exceeded
+ * (they stay alive as long as they are used).
+ */
+class BOOST_SYMBOL_EXPORT JsonDocumentCache {
+public:
+  /**
+   * @brief Default memory budget (bytes).
+   */
+  static constexpr size_t DefaultBudget = 64 * 1024 * 1024;
+
+  /**
+   * @brief Construct a new Json Document Cache.
+   * @param budget Memory budget in bytes (estimated size of the cached documents).
+   */
+  explicit JsonDocumentCache(size_t budget = DefaultBudget);
+
+  JsonDocumentCache(const JsonDocumentCache &) = delete;
+  JsonDocumentCache &operator=(const JsonDocumentCache &) = delete;
+
+  /**
+   * @brief Process wide cache.
+   * @return JsonDocumentCache&
+   */
+  static JsonDocumentCache &instance();
+
+  /**
+   * @brief Document of a file, parsed if not cached (or changed since it was cached). Throws if the file cannot be
+   * read or is not Json. Thread safe: threads missing the same file at the same time wait for a single parse.
+   * @param path
+   * @return std::shared_ptr<const JsonDocument>
+   */
+  std::shared_ptr<const JsonDocument> load(const std::string &path);
+
+  /**
+   * @brief Change the memory budget (evicting documents if needed).
+   * @param budget
+   */
+  void setBudget(size_t budget);
+  /**
+   * @brief Drop all the cached documents.
+   */
+  void clear();
+  /**
+   * @brief Estimated size of the cached documents.
+   * @return size_t
+   */
+  size_t size() const;
+  /**
+   * @brief Number of cached documents.
+   * @return size_t
+   */
+  size_t count() const;
+
+  /**
+   * @brief Estimated memory size of a Json value.
+   * @param jv
+   * @return size_t
+   */
+  static size_t footprint(const boost::json::value &jv);
+
+private:
+  struct Entry {
+    std::string path;
+    uint64_t fileSize;
+    std::filesystem::file_time_type mtime;
+    size_t footprint;
+    std::shared_ptr<const JsonDocument> document;
+  };
+
+  /**
+   * @brief File being parsed: threads loading the same file wait for its document.
+   */
+  struct Loading {
+    uint64_t fileSize;
+    std::filesystem::file_time_type mtime;
+    uint64_t ticket;
+    std::shared_future<std::shared_ptr<const JsonDocument>> document;
+  };
+
+  /**
+   * @brief Cached document of a file if it did not change (made the most recently used), stale entry dropped otherwise.
+   * Called with m_mutex held.
+   * @param path
+   * @param fileSize
+   * @param mtime
+   * @param keepNewer Keep (and return) an entry cached from a newer file: the caller parsed the file before it changed,
+   * its document must not replace the newer one.
+   * @return std::shared_ptr<const JsonDocument> (nullptr when not cached)
+   */
+  std::shared_ptr<const JsonDocument> find(const std::string &path, uint64_t fileSize, std::filesystem::file_time_type mtime,
+                                           bool keepNewer = false);
+  /**
+   * @brief Forget a file being parsed, unless another parse of it started since. Called with m_mutex held.
+   * @param path
+   * @param ticket
+   */
+  void loaded(const std::string &path, uint64_t ticket);
+  /**
+   * @brief Drop the least recently used documents until the budget is met. Called with m_mutex held.
+   */
+  void evict();
+
+  mutable std::mutex m_mutex;
+  size_t m_budget;
+  size_t m_size = 0;
+  /**
+   * @brief Most recently used first.
+   */
+  std::list<Entry> m_entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+  std::unordered_map<std::string, Loading> m_loading;
+  uint64_t m_tickets = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Boost
+#include <boost/json.hpp>
+
+/**
+ * @brief JsonIndex Class. Sidecar index of a Json document written by json_oarchive (set_index()): byte range of each
+ * top-level member, and byte offset of every stride-th element of the top-level arrays.
+ *
+ * Offsets are counted in the Json text (before any compression). With the index, elements of a large array are read
+ * from the text (a MappedFile...) without parsing the rest of it: only the stride elements chunks holding them are.
+ */
+class BOOST_SYMBOL_EXPORT JsonIndex {
+public:
+  /**
+   * @brief Index entry of a top-level member.
+   */
+  struct Entry {
+    /**
+     * @brief Byte range of the member value.
+     */
+    uint64_t offset = 0;
+    uint64_t end = 0;
+    /**
+     * @brief Arrays: number of elements, and byte offset of every stride-th element (elements 0, stride, 2*stride...).
+     */
+    size_t size = 0;
+    std::vector<uint64_t> elements;
+    /**
+     * @brief Arrays: elements holding class information (written with the first object of each class only).
+     */
+    std::vector<size_t> classElements;
+  };
+
+  /**
+   * @brief Construct a new Json Index.
+   * @param stride Number of array elements per indexed offset.
+   */
+  explicit JsonIndex(size_t stride = 1);
+
+  /**
+   * @brief Read an index written by save(). Throws if the input is not an index.
+   * @param is
+   * @return JsonIndex
+   */
+  static JsonIndex load(std::istream &is);
+  /**
+   * @brief Write the index (as Json).
+   * @param os
+   */
+  void save(std::ostream &os) const;
+
+  /**
+   * @brief Number of array elements per indexed offset.
+   * @return size_t
+   */
+  size_t stride() const { return m_stride; }
+  /**
+   * @brief Entry of a top-level member.
+   * @param name
+   * @return const Entry* (nullptr when not indexed)
+   */
+  const Entry *find(const std::string &name) const;
+  /**
+   * @brief Create (or reset) the entry of a top-level member.
+   * @param name
+   * @return Entry&
+   */
+  Entry &add(const std::string &name);
+
+  /**
+   * @brief Parse the value of a top-level member. Throws if not indexed.
+   * @param text Indexed Json document.
+   * @param name
+   * @return boost::json::value
+   */
+  boost::json::value value(std::string_view text, const std::string &name) const;
+  /**
+   * @brief Parse elements [first, first + count) of a top-level array. Throws if out of range.
+   * @param text Indexed Json document.
+   * @param name
+   * @param first
+   * @param count
+   * @return boost::json::array
+   */
+  boost::json::array elements(std::string_view text, const std::string &name, size_t first, size_t count) const;
+  /**
+   * @brief Parse the elements of a top-level array before first that hold class information: loaded before
+   * elements [first, ...), they register the classes as the whole array did.
+   * @param text Indexed Json document.
+   * @param name
+   * @param first
+   * @return boost::json::array
+   */
+  boost::json::array classElements(std::string_view text, const std::string &name, size_t first) const;
+
+private:
+  /**
+   * @brief Parse the k-th chunk (stride elements) of an indexed array.
+   */
+  boost::json::array chunk(std::string_view text, const Entry &entry, size_t k) const;
+
+  size_t m_stride;
+  std::map<std::string, Entry> m_entries;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <ios>
+#include <ostream>
+#include <string>
+
+// Boost
+#include <boost/config.hpp>
+
+/**
+ * @brief JsonSink Class. Destination of the buffers filled by a JsonWriter.
+ */
+class BOOST_SYMBOL_EXPORT JsonSink {
+public:
+  virtual ~JsonSink() = default;
+
+  /**
+   * @brief Consume a filled buffer.
+   * The sink may take the buffer over, by swapping it with another (empty) one.
+   * @param buffer
+   */
+  virtual void write(std::string &buffer) = 0;
+  /**
+   * @brief Make all the written data reach its destination. Throws on failure.
+   */
+  virtual void flush() = 0;
+  /**
+   * @brief End of output (nothing is written afterwards): complete and flush the written data. Throws on failure.
+   */
+  virtual void finish() { flush(); }
+  /**
+   * @brief Number of significant digits of floating point numbers in prettified output.
+   * @return int
+   */
+  virtual int precision() const { return 6; }
+  /**
+   * @brief Formatting flags of floating point numbers in prettified output (floatfield, showpoint, showpos, uppercase).
+   * @return std::ios_base::fmtflags
+   */
+  virtual std::ios_base::fmtflags flags() const { return std::ios_base::fmtflags(); }
+};
+
+/**
+ * @brief OStreamSink Class. JsonSink writing to a std::ostream.
+ */
+class BOOST_SYMBOL_EXPORT OStreamSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new OStream Sink.
+   * @param os
+   */
+  explicit OStreamSink(std::ostream &os) : m_os{os} {}
+
+  void write(std::string &buffer) override;
+  void flush() override;
+  int precision() const override { return static_cast<int>(m_os.precision()); }
+  std::ios_base::fmtflags flags() const override { return m_os.flags(); }
+
+private:
+  std::ostream &m_os;
+};
+
+/**
+ * @brief StringSink Class. JsonSink appending to a std::string (reserve it with json_oarchive::measure()).
+ */
+class BOOST_SYMBOL_EXPORT StringSink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new String Sink.
+   * @param str
+   */
+  explicit StringSink(std::string &str) : m_str{str} {}
+
+  void write(std::string &buffer) override { m_str.append(buffer); }
+  void flush() override {}
+
+private:
+  std::string &m_str;
+};
+
+/**
+ * @brief MemorySink Class. JsonSink writing to a caller provided memory area (preallocated buffer, shared memory...).
+ * Throws when the area is too small.
+ */
+class BOOST_SYMBOL_EXPORT MemorySink : public JsonSink {
+public:
+  /**
+   * @brief Construct a new Memory Sink.
+   * @param data
+   * @param capacity
+   */
+  MemorySink(char *data, size_t capacity) : m_data{data}, m_capacity{capacity} {}
+
+  void write(std::string &buffer) override;
+  void flush() override {}
+
+  /**
+   * @brief Number of bytes written.
+   * @return size_t
+   */
+  size_t size() const { return m_size; }
+
+private:
+  char *m_data;
+  size_t m_capacity;
+  size_t m_size = 0;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Boost
+#include <boost/json.hpp>
+
+// Boost Archive JSON
+#include "boost/JsonSink.hpp"
+
+/**
+ * @brief JsonSnapshot Class. Binary form of a boost::json::value tree, loaded without any text parsing: a load-speed
+ * cache of a Json document (the Json text stays the interchange format). Decoding a snapshot gives the same value as
+ * parsing the Json text of the encoded value.
+ *
+ * Layout (little-endian, offsets counted from the start of the snapshot, so it can be mapped anywhere):
+ * - header: "BJSN", format version (u32), size of the snapshot (u64), root node offset (u64);
+ * - node: kind (u8), then
+ *   - int64/uint64/double: 8 bytes,
+ *   - string: length (u64) and bytes,
+ *   - array: count (u64) and count element node offsets (u64),
+ *   - object: count (u64) and count (key string node offset, value node offset) pairs (u64).
+ */
+class BOOST_SYMBOL_EXPORT JsonSnapshot {
+public:
+  /**
+   * @brief Size of the header.
+   */
+  static constexpr size_t HeaderSize = 24;
+
+  /**
+   * @brief Encode a Json value.
+   * @param jv
+   * @return std::string
+   */
+  static std::string encode(const boost::json::value &jv);
+  /**
+   * @brief Encode a Json value into a sink.
+   * @param jv
+   * @param sink
+   */
+  static void write(const boost::json::value &jv, JsonSink &sink);
+  /**
+   * @brief Return true if the data starts with a snapshot header.
+   * @param data
+   * @return true
+   * @return false
+   */
+  static bool isSnapshot(std::string_view data);
+  /**
+   * @brief Decode a snapshot (a MappedFile...). Throws if the data is not a valid snapshot.
+   * @param data
+   * @param sp Storage of the decoded tree.
+   * @return boost::json::value
+   */
+  static boost::json::value decode(std::string_view data, boost::json::storage_ptr sp = {});
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <istream>
+
+// Boost
+#include <boost/config.hpp>
+
+/**
+ * @brief JsonSource Class. Origin of the data parsed by a json_iarchive, read by blocks.
+ */
+class BOOST_SYMBOL_EXPORT JsonSource {
+public:
+  /**
+   * @brief Size of the blocks read by the Json parser.
+   */
+  static constexpr size_t BlockSize = 64 * 1024;
+
+  virtual ~JsonSource() = default;
+
+  /**
+   * @brief Read up to size bytes. Throws on failure.
+   * @param data
+   * @param size
+   * @return size_t Number of bytes read (0: end of data).
+   */
+  virtual size_t read(char *data, size_t size) = 0;
+};
+
+/**
+ * @brief IStreamSource Class. JsonSource reading from a std::istream.
+ */
+class BOOST_SYMBOL_EXPORT IStreamSource : public JsonSource {
+public:
+  /**
+   * @brief Construct a new IStream Source.
+   * @param is
+   */
+  explicit IStreamSource(std::istream &is) : m_is{is} {}
+
+  size_t read(char *data, size_t size) override;
+
+private:
+  std::istream &m_is;
+};
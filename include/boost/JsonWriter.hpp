@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Boost Archive JSON
+#include <boost/json.hpp>
+
+#include "boost/JsonIndex.hpp"
+#include "boost/JsonSink.hpp"
+
+/**
+ * @brief Json object key, checked at compile time when built from a literal (metadata keys).
+ * NVP names reach the writer through the Json tree: they are checked once, when first written.
+ */
+class JsonKey {
+public:
+  /**
+   * @brief Construct a new Json Key.
+   * @param name
+   */
+  constexpr JsonKey(std::string_view name) : m_name(name), m_plain(isPlain(name)) {}
+
+  /**
+   * @brief Return true if the character must be escaped inside a Json string.
+   * @param c
+   * @return true
+   * @return false
+   */
+  static constexpr bool needsEscape(char c) {
+    return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+  }
+
+  /**
+   * @brief Return true if the string can be emitted verbatim between quotes.
+   * @param s
+   * @return true
+   * @return false
+   */
+  static constexpr bool isPlain(std::string_view s) {
+    for (char c : s) {
+      if (needsEscape(c)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Raw key name.
+   * @return std::string_view
+   */
+  constexpr std::string_view name() const { return m_name; }
+
+  /**
+   * @brief Return true if the key does not need escaping.
+   * @return true
+   * @return false
+   */
+  constexpr bool plain() const { return m_plain; }
+
+private:
+  std::string_view m_name;
+  bool m_plain;
+};
+
+/**
+ * @brief JsonWriter Class. Buffered Json serializer for boost::json::value trees (compact or prettified).
+ *
+ * Object keys are escaped once and cached as ready-to-emit tokens (quotes and separator included),
+ * so each further occurrence of a key costs a hash lookup and a single copy into the output buffer.
+ */
+class BOOST_SYMBOL_EXPORT JsonWriter {
+public:
+  /**
+   * @brief Size of the output buffer handed to the sink at once.
+   */
+  static constexpr size_t BufferSize = 64 * 1024;
+  /**
+   * @brief Maximum number of cached key tokens.
+   */
+  static constexpr size_t MaxCachedKeys = 4096;
+  /**
+   * @brief Usual size of a formatted floating point number (longer ones are formatted again).
+   */
+  static constexpr size_t NumberSize = 64;
+
+  /**
+   * @brief Construct a new Json Writer.
+   * @param os
+   * @param prettify
+   * @param bufferSize Size of the output buffer handed to the stream at once.
+   */
+  explicit JsonWriter(std::ostream &os, bool prettify = false, size_t bufferSize = BufferSize);
+  /**
+   * @brief Construct a new Json Writer.
+   * @param sink
+   * @param prettify
+   * @param bufferSize Size of the output buffer handed to the sink at once.
+   */
+  explicit JsonWriter(JsonSink &sink, bool prettify = false, size_t bufferSize = BufferSize);
+
+  /**
+   * @brief Write a whole Json document.
+   * @param jv
+   */
+  void write(const boost::json::value &jv);
+  /**
+   * @brief Write a Json document followed by a newline (JSON Lines record, with a compact writer).
+   * @param jv
+   */
+  void writeLine(const boost::json::value &jv);
+  /**
+   * @brief Exact number of bytes written by write(jv) (nothing is written).
+   * @param jv
+   * @return size_t
+   */
+  size_t size(const boost::json::value &jv);
+  /**
+   * @brief Open a Json document object, to be written member by member (same output as write()).
+   */
+  void beginObject();
+  /**
+   * @brief Write a member of the document object opened by beginObject().
+   * @param key
+   * @param jv
+   */
+  void writeMember(boost::json::string_view key, const boost::json::value &jv);
+  /**
+   * @brief Write a member of the document object opened by beginObject(), recording its byte offsets into an index.
+   * @param key
+   * @param jv
+   * @param index
+   */
+  void writeMember(boost::json::string_view key, const boost::json::value &jv, JsonIndex &index);
+  /**
+   * @brief Close the document object opened by beginObject().
+   */
+  void endObject();
+  /**
+   * @brief Hand buffered output to the sink (the sink itself is not flushed).
+   */
+  void flush();
+  /**
+   * @brief Number of bytes written so far (buffered output included).
+   * @return uint64_t
+   */
+  uint64_t written() const { return m_written + m_buffer.size(); }
+  /**
+   * @brief Write object members sorted by key (bytes) and negative zeros as zeros: with a compact writer, equal
+   * documents give identical bytes whatever their members insertion order.
+   * @param canonical
+   */
+  void setCanonical(bool canonical) { m_canonical = canonical; }
+
+private:
+  JsonWriter(std::unique_ptr<JsonSink> streamSink, JsonSink *sink, bool prettify, size_t bufferSize);
+
+  void writeValue(const boost::json::value &jv);
+  void writeObject(const boost::json::object &obj);
+  void writeArray(const boost::json::array &arr, JsonIndex::Entry *entry = nullptr, size_t stride = 1);
+  void writeKey(boost::json::string_view key);
+  void writeString(boost::json::string_view str);
+  void writeDouble(double d);
+  std::string_view formatDouble(double d);
+  size_t stringSize(boost::json::string_view str);
+  size_t valueSize(const boost::json::value &jv, size_t depth);
+  template <typename T> void writeInteger(T i);
+  void cacheKey(JsonKey key);
+  void append(const char *data, size_t size);
+  void append(std::string_view sv) { append(sv.data(), sv.size()); }
+
+  /**
+   * @brief Sink owned by the writer (std::ostream output).
+   */
+  std::unique_ptr<JsonSink> m_streamSink;
+  JsonSink &m_sink;
+  bool m_prettify;
+  bool m_canonical = false;
+  size_t m_bufferSize;
+  /**
+   * @brief No member written yet in the object opened by beginObject().
+   */
+  bool m_first = true;
+  /**
+   * @brief Number of bytes handed to the sink.
+   */
+  uint64_t m_written = 0;
+  std::string m_buffer;
+  std::string m_indent;
+  /**
+   * @brief Last formatted floating point number.
+   */
+  std::string m_number;
+  /**
+   * @brief Cached key tokens storage (deque: stable addresses).
+   */
+  std::deque<std::string> m_tokens;
+  /**
+   * @brief Raw key -> emitted token ("key": or "key" : ).
+   */
+  std::unordered_map<std::string_view, std::string_view> m_keys;
+  boost::json::serializer m_serializer;
+};
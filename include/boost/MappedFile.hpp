@@ -0,0 +1,37 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <string>
+#include <string_view>
+
+// Boost
+#include <boost/config.hpp>
+
+/**
+ * @brief MappedFile Class. Read-only memory mapping of a whole file (mmap): its pages are only read when accessed.
+ */
+class BOOST_SYMBOL_EXPORT MappedFile {
+public:
+  /**
+   * @brief Map a file. Throws if it cannot be opened or mapped.
+   * @param path
+   */
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief Content of the file.
+   * @return std::string_view
+   */
+  std::string_view data() const { return {m_data, m_size}; }
+
+private:
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Boost Archive JSON
+#include "boost/JsonSource.hpp"
+
+/**
+ * @brief ReadAheadSource Class. JsonSource reading (and decompressing) the blocks of another source on a dedicated
+ * thread, while the previous blocks are being parsed.
+ *
+ * At most `blocks` blocks are read ahead. Errors of the reading thread are rethrown by read().
+ */
+class BOOST_SYMBOL_EXPORT ReadAheadSource : public JsonSource {
+public:
+  /**
+   * @brief Construct a new Read Ahead Source.
+   * @param source
+   * @param blocks Maximum number of blocks read ahead (at least 1).
+   * @param blockSize
+   */
+  explicit ReadAheadSource(JsonSource &source, size_t blocks = 4, size_t blockSize = BlockSize);
+  /**
+   * @brief Destroy the Read Ahead Source. Stops the reading thread.
+   */
+  ~ReadAheadSource();
+
+  ReadAheadSource(const ReadAheadSource &) = delete;
+  ReadAheadSource &operator=(const ReadAheadSource &) = delete;
+
+  size_t read(char *data, size_t size) override;
+
+private:
+  void run();
+
+  JsonSource &m_source;
+  size_t m_capacity;
+  size_t m_blockSize;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  /**
+   * @brief Blocks read ahead (the front one is consumed from m_offset).
+   */
+  std::deque<std::string> m_blocks;
+  size_t m_offset = 0;
+  /**
+   * @brief Consumed blocks, ready to be reused.
+   */
+  std::vector<std::string> m_free;
+  bool m_end = false;
+  bool m_stop = false;
+  std::exception_ptr m_error;
+  std::thread m_thread;
+};
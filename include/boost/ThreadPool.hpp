@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Boost
+#include <boost/config.hpp>
+
+/**
+ * @brief ThreadPool Class. Fixed size pool of worker threads used by the Json archives parallel modes.
+ */
+class BOOST_SYMBOL_EXPORT ThreadPool {
+public:
+  /**
+   * @brief Construct a new Thread Pool.
+   * @param threads Number of worker threads (at least 1).
+   */
+  explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+  /**
+   * @brief Destroy the Thread Pool. Pending tasks are run before the workers are joined.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Process wide pool (one worker per hardware thread).
+   * @return ThreadPool&
+   */
+  static ThreadPool &instance();
+
+  /**
+   * @brief Number of worker threads.
+   * @return size_t
+   */
+  size_t size() const { return m_threads.size(); }
+
+  /**
+   * @brief Queue a task.
+   * Tasks must not wait on other tasks of the same pool.
+   * @tparam F
+   * @param f
+   * @return std::future<std::invoke_result_t<F>>
+   */
+  template <typename F> std::future<std::invoke_result_t<F>> submit(F &&f) {
+    auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(f));
+    auto future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.emplace([task]() { (*task)(); });
+    }
+    m_cv.notify_one();
+    return future;
+  }
+
+private:
+  void run();
+
+  std::vector<std::thread> m_threads;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+};
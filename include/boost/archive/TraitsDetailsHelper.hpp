@@ -2,6 +2,9 @@
 
 #include <boost/archive/basic_archive.hpp>
 #include <map>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -42,6 +45,30 @@ template <typename T, typename... OtherTs> struct is_std_map<std::map<T, OtherTs
 
 template <typename T, typename... OtherTs> struct is_std_map<std::unordered_map<T, OtherTs...>> : std::true_type {};
 
+template <typename T> struct is_std_unordered_map : std::false_type {};
+
+template <typename T, typename... OtherTs> struct is_std_unordered_map<std::unordered_map<T, OtherTs...>> : std::true_type {};
+
+template <typename T>
+struct is_json_string
+    : std::integral_constant<bool, std::is_same<T, std::string>::value || std::is_same<T, std::string_view>::value> {};
+
+template <typename T>
+struct is_json_object
+    : std::integral_constant<bool, std::is_class<T>::value && !is_json_string<T>::value && !is_std_vector<T>::value &&
+                                       !is_fixed_size_array<T>::value && !is_std_map<T>::value && !is_shared_ptr<T>::value &&
+                                       !is_weak_ptr<T>::value && !is_unique_ptr<T>::value> {};
+
+/**
+ * @brief Types saved into the root object itself when they are the first top-level NVP ({"<type>":"<name>",
+ * members...}): class objects and pointers.
+ */
+template <typename T>
+struct is_root_object
+    : std::integral_constant<bool, (std::is_class<T>::value || std::is_pointer<T>::value) && !is_json_string<T>::value &&
+                                       !is_std_vector<T>::value && !is_std_map<T>::value &&
+                                       !is_fixed_size_array<T>::value> {};
+
 } // namespace detail
 
 } // namespace archive
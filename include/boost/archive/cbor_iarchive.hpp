@@ -0,0 +1,43 @@
+#ifndef BOOST_JSON_ARCHIVE_CBOR_IARCHIVE_H
+#define BOOST_JSON_ARCHIVE_CBOR_IARCHIVE_H
+
+// C++ Standard Library
+#include <istream>
+#include <string_view>
+
+// Boost Archive JSON
+#include "boost/archive/json_iarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+/**
+ * @brief CBOR input archive: reads documents written by cbor_oarchive (see JsonCbor), with the same traversal,
+ * metadata and flags as json_iarchive.
+ */
+class BOOST_SYMBOL_EXPORT cbor_iarchive : public json_iarchive {
+public:
+  /**
+   * @brief Construct a new CBOR Input Archive. Throws if the input is not CBOR.
+   * @param is
+   * @param flags
+   */
+  explicit cbor_iarchive(std::istream &is, unsigned int flags = 0);
+  /**
+   * @brief Construct a new CBOR Input Archive reading a source.
+   * @param source
+   * @param flags
+   */
+  explicit cbor_iarchive(JsonSource &source, unsigned int flags = 0);
+  /**
+   * @brief Construct a new CBOR Input Archive reading a document held in memory (a MappedFile...).
+   * @param data
+   * @param flags
+   */
+  explicit cbor_iarchive(std::string_view data, unsigned int flags = 0);
+};
+
+} // namespace archive
+} // namespace boost
+
+#endif // BOOST_JSON_ARCHIVE_CBOR_IARCHIVE_H
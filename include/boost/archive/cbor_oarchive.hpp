@@ -0,0 +1,37 @@
+#ifndef BOOST_JSON_ARCHIVE_CBOR_OARCHIVE_H
+#define BOOST_JSON_ARCHIVE_CBOR_OARCHIVE_H
+
+// C++ Standard Library
+#include <ostream>
+
+// Boost Archive JSON
+#include "boost/archive/json_oarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+/**
+ * @brief CBOR output archive: same traversal, metadata and flags as json_oarchive, but the document is written as
+ * CBOR (RFC 8949, see JsonCbor) instead of Json text. The document is written as a whole at finish()
+ * (no flush threshold, no index); it can be read back by cbor_iarchive.
+ */
+class BOOST_SYMBOL_EXPORT cbor_oarchive : public json_oarchive {
+public:
+  /**
+   * @brief Construct a new CBOR Output Archive.
+   * @param os
+   * @param flags
+   */
+  explicit cbor_oarchive(std::ostream &os, unsigned int flags = 0);
+  /**
+   * @brief Construct a new CBOR Output Archive writing to a sink.
+   * @param sink
+   * @param flags
+   */
+  explicit cbor_oarchive(JsonSink &sink, unsigned int flags = 0);
+};
+
+} // namespace archive
+} // namespace boost
+
+#endif // BOOST_JSON_ARCHIVE_CBOR_OARCHIVE_H
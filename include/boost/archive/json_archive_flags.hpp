@@ -0,0 +1,52 @@
+#pragma once
+
+#include <boost/archive/basic_archive.hpp>
+
+namespace boost {
+namespace archive {
+
+/**
+ * @brief Json archives specific flags, to be combined with boost::archive::archive_flags.
+ */
+enum json_archive_flags {
+  /**
+   * @brief Write vectors/arrays of class objects as one object holding a value array per member.
+   */
+  json_columnar = (flags_last << 1),
+  /**
+   * @brief Write string values once in a root "string_table" and reference them by index.
+   */
+  json_string_table = (flags_last << 2),
+  /**
+   * @brief Skip members equal to their value-initialized default on save, restore the default for missing members on load.
+   */
+  json_elide_defaults = (flags_last << 3),
+  /**
+   * @brief Write bool vectors/arrays as a base64 bitstring.
+   */
+  json_packed_bools = (flags_last << 4),
+  /**
+   * @brief Save/load large vectors/arrays of class objects on the thread pool. Results are identical to a sequential
+   * save/load (falls back to sequential when elements carry class information, or with json_string_table on save).
+   */
+  json_parallel = (flags_last << 5),
+  /**
+   * @brief Write a binary JsonSnapshot instead of Json text, at finish() (no flush threshold, no index).
+   * json_iarchive reads both.
+   */
+  json_snapshot = (flags_last << 6),
+  /**
+   * @brief Write canonical Json text at finish(): object members sorted by key (bytes), compact, numbers in a single
+   * form (prettify, flush threshold and index are ignored). Equal documents give identical bytes (see DigestSink).
+   */
+  json_canonical = (flags_last << 7),
+  /**
+   * @brief Load an RFC 7386 merge patch (see json_oarchive::set_baseline()) into already populated objects: members
+   * missing from the Json are left untouched, null members are reset to their value-initialized default (vectors
+   * are replaced as a whole, their elements reused).
+   */
+  json_merge_patch = (flags_last << 8),
+};
+
+} // namespace archive
+} // namespace boost
@@ -2,9 +2,16 @@
 #define BOOST_JSON_ARCHIVE_IARCHIVE_H
 
 // C++ Standard Library
+#include <algorithm>
+#include <exception>
+#include <future>
 #include <istream>
 #include <iterator>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
 
 // Boost
 #include <boost/archive/detail/common_iarchive.hpp>
@@ -12,7 +19,11 @@
 
 // Boost Archive JSON
 #include "boost/JsonContext.hpp"
+#include "boost/JsonDocument.hpp"
+#include "boost/JsonIndex.hpp"
+#include "boost/ThreadPool.hpp"
 #include "boost/archive/TraitsDetailsHelper.hpp"
+#include "boost/archive/json_archive_flags.hpp"
 
 namespace boost {
 namespace archive {
@@ -20,20 +31,89 @@ namespace archive {
 class BOOST_SYMBOL_EXPORT json_iarchive : public detail::common_iarchive<json_iarchive> {
 public:
   explicit json_iarchive(std::istream &is, unsigned int = 0);
+  /**
+   * @brief Construct a new Json Input Archive reading from a source (parsed block by block).
+   * @param source
+   * @param flags
+   */
+  explicit json_iarchive(JsonSource &source, unsigned int flags = 0);
+  /**
+   * @brief Construct a new Json Input Archive reading a document held in memory (a MappedFile...):
+   * Json text, or JsonSnapshot (decoded without any text parsing).
+   * @param data
+   * @param flags
+   */
+  explicit json_iarchive(std::string_view data, unsigned int flags = 0);
+  /**
+   * @brief Construct a new Json Input Archive loading a single value, located by a Json pointer: the other values
+   * are skipped without being parsed (see JsonContext::project()). The value is loaded as the nvp named after the last
+   * pointer token ("/settings/network" is loaded with ia >> make_nvp("network", network)).
+   * The value must not refer to class information written before it (tracked objects, pointers...).
+   * Throws if the value is not found.
+   * @param source
+   * @param pointer
+   * @param flags
+   */
+  json_iarchive(JsonSource &source, const std::string &pointer, unsigned int flags = 0);
+  /**
+   * @brief Construct a new Json Input Archive loading a single value, located by a Json pointer
+   * (see json_iarchive(JsonSource &, const std::string &, unsigned int)).
+   * @param is
+   * @param pointer
+   * @param flags
+   */
+  json_iarchive(std::istream &is, const std::string &pointer, unsigned int flags = 0);
+  /**
+   * @brief Construct a new Json Input Archive loading elements [first, first + count) of a top-level array, located
+   * in the document text (a MappedFile...) with its sidecar index (see json_oarchive::set_index()): only the chunks
+   * of the index holding them are parsed. They are loaded as the nvp name (ia >> make_nvp(name, vec)).
+   * The elements holding class information before first are loaded beforehand (discarded). Class and object ids are
+   * numbered over the whole document: elements with pointers or object references cannot be loaded alone, and are
+   * rejected.
+   * @param text
+   * @param index
+   * @param name
+   * @param first
+   * @param count
+   * @param flags
+   */
+  json_iarchive(std::string_view text, const JsonIndex &index, const std::string &name, size_t first, size_t count,
+                unsigned int flags = 0);
+  /**
+   * @brief Construct a new Json Input Archive reading a subtree of a shared document (nothing is parsed).
+   * Archives sharing a document can be used concurrently, from different threads.
+   * @param document
+   * @param pointer Json pointer of the subtree ("": the whole document). Throws if not found.
+   * @param flags
+   */
+  explicit json_iarchive(std::shared_ptr<const JsonDocument> document, const std::string &pointer = "",
+                         unsigned int flags = 0);
 
   ~json_iarchive() = default;
 
   template <typename T>
-  std::enable_if_t<std::is_fundamental<T>::type::value || std::is_same<T, std::string>::type::value> load_fundamental(T &value) {
-    if (m_ctx.current().second->is_object() && !m_ctx.current().second->get_object()[m_ctx.currentTag().c_str()].is_null()) {
-      value = JsonContext::get<T>(m_ctx.current().second->get_object()[m_ctx.currentTag().c_str()]);
-    } else if (!m_ctx.current().second->is_null()) {
-      value = JsonContext::get<T>(*m_ctx.current().second);
+  std::enable_if_t<std::is_fundamental<T>::type::value || detail::is_json_string<T>::value> load_fundamental(T &value) {
+    const boost::json::value &current = *m_ctx.current().second;
+    const boost::json::value *member = current.is_object() ? current.get_object().if_contains(m_ctx.currentTag()) : nullptr;
+    if (member && !member->is_null()) {
+      assign(value, *member);
+    } else if (!current.is_null() && !(current.is_object() && member)) {
+      assign(value, current);
+    } else if (this->get_flags() & json_elide_defaults) {
+      value = T();
     } else {
       throw std::runtime_error("Json value not found !");
     }
   }
 
+  /**
+   * @brief Load a Json string into a char buffer (NUL terminated). Throws if it does not fit.
+   * @param buffer
+   * @param size
+   * @return false if the loaded value is not a string (char array).
+   */
+  bool load_chars(char *buffer, size_t size);
+
   template <typename T> void load_smart_ptr(T &value) {
     typename T::element_type *t = nullptr;
     detail::common_iarchive<json_iarchive>::load_override(t);
@@ -58,59 +138,169 @@ public:
   }
 
   template <typename T> void load(std::vector<T> &value) {
-    size_t current_capacity = value.capacity();
-    value.clear();
-    value.reserve(current_capacity);
-    boost::system::error_code ec;
-    boost::json::value *pxp = nullptr;
-    if (!m_ctx.top().second->is_array()) {
-      m_ctx.pop();
-      pxp = m_ctx.top().second->find_pointer("/px/" + m_ctx.currentTag(), ec);
-    }
-    if (m_ctx.top().second->is_array() || (pxp && !ec)) {
-      auto &array = pxp ? pxp->get_array() : m_ctx.top().second->get_array();
-      unsigned int index = 0;
-      for (auto &val : array) {
-        if constexpr ((std::is_class<T>::value && !std::is_same<T, std::string>::value) || std::is_pointer<T>::value) {
-          m_ctx.push(std::to_string(index), std::make_shared<json::value>(val));
-
-          T _val;
-          load(_val);
-          if constexpr (detail::is_unique_ptr<T>::value) {
-            value.push_back(std::move(_val));
-          } else {
-            value.push_back(_val);
-          }
+    boost::json::value *node = array_node();
+    if (!node) {
+      if (!(this->get_flags() & json_merge_patch)) {
+        value.clear();
+      }
+      return;
+    }
+    load_vector(value, *node);
+  }
 
-          m_ctx.pop();
-        } else {
-          value.push_back(JsonContext::get<T>(val));
+  /**
+   * @brief Load a vector from its Json value (array, columns or packed bits).
+   * Existing elements are reused (loaded in place), except pointers; storage is reserved once.
+   * @tparam T
+   * @param value
+   * @param node
+   */
+  template <typename T> void load_vector(std::vector<T> &value, boost::json::value &node) {
+    constexpr bool in_place = !std::is_pointer<T>::value && !detail::is_shared_ptr<T>::value &&
+                              !detail::is_unique_ptr<T>::value && !detail::is_weak_ptr<T>::value;
+    if (!in_place || !node.is_array()) {
+      value.clear();
+    }
+    if (node.is_array()) {
+      auto &array = node.get_array();
+      if (&node == m_class_elements_of) {
+        load_class_elements<T>();
+      }
+      size_t index = 0;
+      if constexpr (detail::is_json_object<T>::value) {
+        if ((this->get_flags() & json_parallel) && array.size() >= m_parallel_threshold) {
+          index = load_array_parallel(
+              value, array.size(), [&array](size_t i) { return JsonContext::hasMetadata(array[i]); },
+              [&array](json_iarchive &ar, T &item, size_t i) { ar.load_item(item, array[i], i); });
+        }
+      }
+      size_t reused = 0;
+      if constexpr (in_place) {
+        if (index == 0) {
+          reused = std::min(value.size(), array.size());
+          value.erase(value.begin() + static_cast<std::ptrdiff_t>(reused), value.end());
+        }
+      }
+      // Reserved before any element is loaded: loaded elements do not move afterwards (tracked addresses).
+      value.reserve(array.size());
+      if constexpr (in_place) {
+        load_range(value.begin(), array, 0, reused);
+        index += reused;
+      }
+      for (; index < array.size(); index++) {
+        load_element(value, array[index], index);
+      }
+    } else if constexpr (std::is_same<T, bool>::value) {
+      if (JsonContext::isPackedBits(node)) {
+        const size_t offset = value.size();
+        value.resize(offset + JsonContext::packedBitsSize(node));
+        JsonContext::unpackBits(node, value.begin() + static_cast<std::ptrdiff_t>(offset), value.size() - offset);
+      }
+    } else if constexpr (detail::is_json_object<T>::value) {
+      if (JsonContext::isColumnar(node)) {
+        size_t rows = JsonContext::columnsRows(node);
+        const boost::json::array &keys = JsonContext::columnsKeys(node);
+        const boost::json::array &values = JsonContext::columnsValues(node);
+        value.reserve(rows);
+        size_t index = 0;
+        if ((this->get_flags() & json_parallel) && rows >= m_parallel_threshold) {
+          index = load_array_parallel(
+              value, rows, [&keys, &values](size_t i) { return JsonContext::hasMetadata(keys, values, i); },
+              [&keys, &values](json_iarchive &ar, T &item, size_t i) { ar.load_row(item, keys, values, i); });
+        }
+        for (; index < rows; index++) {
+          // Loaded where it is stored, as load_element().
+          value.emplace_back();
+          try {
+            load_row(value.back(), keys, values, index);
+          } catch (...) {
+            value.pop_back();
+            throw;
+          }
         }
-        index++;
       }
     }
   }
 
+  /**
+   * @brief Load a fixed size array (std::array or C array) in place (elements beyond the Json array size are left
+   * untouched).
+   * @tparam T
+   * @param value
+   */
+  template <typename T> void load_fixed(T &value) {
+    using element_type = std::remove_reference_t<decltype(*std::begin(value))>;
+    boost::json::value *node = array_node();
+    if (!node) {
+      return;
+    }
+    if (node->is_array()) {
+      auto &array = node->get_array();
+      load_range(std::begin(value), array, 0, std::min(array.size(), std::size(value)));
+      return;
+    }
+    if constexpr (std::is_same<element_type, bool>::value) {
+      if (JsonContext::isPackedBits(*node)) {
+        JsonContext::unpackBits(*node, std::data(value), std::min(JsonContext::packedBitsSize(*node), std::size(value)));
+        return;
+      }
+    }
+    // Columns.
+    std::vector<element_type> vec;
+    load_vector(vec, *node);
+    std::move(vec.begin(), vec.begin() + static_cast<std::ptrdiff_t>(std::min(vec.size(), std::size(value))),
+              std::begin(value));
+  }
+
+  /**
+   * @brief Load a std::map/std::unordered_map (Json array of pairs): each pair is loaded then moved into the map.
+   * @tparam T
+   * @param value
+   */
+  template <typename T> void load_map(T &value) {
+    value.clear();
+    boost::json::value *node = array_node();
+    if (!node) {
+      return;
+    }
+    using pair_type = std::pair<typename T::key_type, typename T::mapped_type>;
+    if (!node->is_array()) {
+      std::vector<pair_type> vec;
+      load_vector(vec, *node);
+      for (auto &pair : vec) {
+        value.emplace_hint(value.end(), std::move(pair));
+      }
+      return;
+    }
+    auto &array = node->get_array();
+    if constexpr (detail::is_std_unordered_map<T>::value) {
+      value.reserve(array.size());
+    }
+    for (size_t index = 0; index < array.size(); index++) {
+      pair_type pair;
+      load_range(&pair, array, index, index + 1);
+      value.emplace_hint(value.end(), std::move(pair));
+    }
+  }
+
   template <typename T> void load(T &value) {
-    if constexpr (std::is_fundamental<T>::value || std::is_same<T, std::string>::value) {
+    if constexpr (std::is_fundamental<T>::value || detail::is_json_string<T>::value) {
       load_fundamental(value);
     } else if constexpr (std::is_enum<T>::value) {
       int64_t converted = -1;
       load_fundamental(converted);
       value = static_cast<T>(converted);
     } else if constexpr (detail::is_fixed_size_old_school_array<T>::value) {
-      std::array<typename std::remove_all_extents<T>::type, detail::is_fixed_size_old_school_array<T>::size> arr;
-      load(arr);
-      std::copy(arr.begin(), arr.end(), std::begin(value));
+      if constexpr (std::is_same<std::remove_extent_t<T>, char>::value) {
+        if (load_chars(value, detail::is_fixed_size_old_school_array<T>::size)) {
+          return;
+        }
+      }
+      load_fixed(value);
     } else if constexpr (detail::is_fixed_size_array<T>::value) {
-      std::vector<typename T::value_type> vec;
-      load(vec);
-      std::copy(vec.begin(), vec.end(), std::begin(value));
+      load_fixed(value);
     } else if constexpr (detail::is_std_map<T>::value) {
-      std::vector<std::pair<typename T::key_type, typename T::mapped_type>> vec;
-      load(vec);
-      std::transform(vec.begin(), vec.end(), std::inserter(value, value.end()),
-                     [](const auto &pair) { return std::make_pair(pair.first, pair.second); });
+      load_map(value);
     } else if constexpr (detail::is_shared_ptr<T>::value || detail::is_unique_ptr<T>::value || detail::is_weak_ptr<T>::value) {
       load_smart_ptr<T>(value);
     } else {
@@ -123,24 +313,36 @@ public:
    *************************************************************************/
   template <typename T> void load_override(const boost::serialization::nvp<T> &nvp) {
     size_t ctx_size = m_ctx.size();
+    // The first top-level class object was saved into the root object itself (no member of its own).
+    const bool root_object = ctx_size == 0 && detail::is_root_object<T>::value;
     if (ctx_size == 0) {
-      m_ctx.setRoot(root_value.is_object() && !root_value.as_object().empty() ? nvp.name() : "",
-                    std::make_shared<boost::json::value>(root_value));
+      // The loaded value is only read: it is pushed without copy, like array elements.
+      m_ctx.setRoot(m_input->is_object() && !m_input->as_object().empty() ? nvp.name() : "",
+                    view(*m_input));
     }
     auto &top_value = m_ctx.top();
+    if ((this->get_flags() & json_merge_patch) && nvp.name() && top_value.second->is_object()) {
+      const boost::json::value *member = find_member(*top_value.second, nvp.name());
+      if (!member && !root_object) {
+        // Unchanged member.
+        return;
+      }
+      if (member && member->is_null()) {
+        // Deleted member: reset to its default value.
+        if constexpr (!std::is_pointer<T>::value && std::is_default_constructible<T>::value &&
+                      std::is_move_assignable<T>::value) {
+          nvp.value() = T();
+        } else {
+          throw std::runtime_error("Json merge patch deletes a member that cannot be reset !");
+        }
+        return;
+      }
+    }
     bool pushed = false;
     bool pxed = false;
     if (nvp.name() && top_value.second->is_object()) {
-      json::value *ptr = nullptr;
-      if (m_px_level > 0) {
-        boost::system::error_code ec;
-        ptr = top_value.second->find_pointer("/px/" + std::string(nvp.name()), ec);
-      }
-      if (m_px_level > 0 && (ptr != nullptr)) {
-        m_ctx.push(nvp.name(), std::make_shared<json::value>(*ptr));
-      } else {
-        m_ctx.push(nvp.name(), std::make_shared<json::value>(top_value.second->get_object()[nvp.name()]));
-      }
+      auto const *member = find_member(*top_value.second, nvp.name());
+      m_ctx.push(nvp.name(), member ? view(*member) : std::make_shared<json::value>());
       pushed = true;
       ctx_size = m_ctx.size();
       m_ctx.setCurrent(nvp.name(), m_ctx.top().second);
@@ -171,11 +373,360 @@ public:
   void load_override(class_id_reference_type &t);
   void load_override(tracking_type &t);
 
+  /**
+   * @brief Minimum number of elements for a vector/array to be loaded in parallel (json_parallel flag).
+   * @param threshold
+   */
+  void set_parallel_threshold(size_t threshold) { m_parallel_threshold = threshold; }
+
 private:
+  friend class json_lines_iarchive;
+  friend class cbor_iarchive;
+
+  /**
+   * @brief Construct an archive reading an already parsed Json document.
+   * @param root
+   * @param flags
+   */
+  json_iarchive(boost::json::value &&root, unsigned int flags);
+  /**
+   * @brief Construct a detached archive (no input stream), used to load parts of the Json tree on worker threads.
+   * @param flags
+   * @param string_table Strings table used to resolve string references (can be nullptr).
+   */
+  json_iarchive(unsigned int flags, const boost::json::array *string_table);
+
+  /**
+   * @brief Projection of a source on a Json pointer. Throws if the pointed value is not found.
+   * @param source
+   * @param pointer
+   * @return boost::json::value
+   */
+  static boost::json::value project(JsonSource &source, const std::string &pointer);
+  static boost::json::value project(std::istream &is, const std::string &pointer);
+  /**
+   * @brief Elements of an indexed array, as a document holding them (and the strings table).
+   * @param text
+   * @param index
+   * @param name
+   * @param first
+   * @param count
+   * @return boost::json::value
+   */
+  static boost::json::value indexed(std::string_view text, const JsonIndex &index, const std::string &name, size_t first,
+                                    size_t count);
+
+  /**
+   * @brief Use the "string_table" of the loaded value (if any) to resolve string references, only with the
+   * json_string_table flag: without it, strings are read as they are, whatever the value members.
+   */
+  void init_string_table();
+
+  /**
+   * @brief Load one array element and append it to the vector.
+   * @tparam T
+   * @param value
+   * @param val
+   * @param index
+   */
+  template <typename T> void load_element(std::vector<T> &value, boost::json::value &val, size_t index) {
+    if constexpr ((std::is_class<T>::value && !detail::is_json_string<T>::value) || std::is_pointer<T>::value) {
+      // Loaded where it is stored: the vector is reserved, elements do not move afterwards (tracked addresses).
+      push_element(index, val);
+      value.emplace_back();
+      try {
+        load(value.back());
+      } catch (...) {
+        value.pop_back();
+        throw;
+      }
+      m_ctx.pop();
+    } else {
+      value.push_back(get<T>(val));
+    }
+  }
+
+  /**
+   * @brief Member of an object (nullptr if missing), looked up under its "px" member first inside pointers.
+   * @param object
+   * @param name
+   * @return const boost::json::value*
+   */
+  const boost::json::value *find_member(const boost::json::value &object, const char *name) const {
+    if (m_px_level > 0) {
+      const boost::json::value *px = member_of(object, "px");
+      if (auto const *members = px ? px->if_object() : nullptr) {
+        if (auto const *member = members->if_contains(name)) {
+          return member;
+        }
+      }
+    }
+    return member_of(object, name);
+  }
+
+  /**
+   * @brief Member of an object, or of the json_columnar row being loaded (nullptr if missing).
+   * @param object
+   * @param key
+   * @return const boost::json::value*
+   */
+  const boost::json::value *member_of(const boost::json::value &object, boost::json::string_view key) const {
+    if (m_row && &object == &m_row->node) {
+      return JsonContext::columnsMember(m_row->keys, m_row->values, m_row->index, key, m_row->cursor);
+    }
+    return object.get_object().if_contains(key);
+  }
+
+  /**
+   * @brief Metadata member of the current object (null if missing).
+   * @param key
+   * @return const boost::json::value&
+   */
+  const boost::json::value &metadata(const std::string &key);
+
+  /**
+   * @brief Json value of the vector/array being loaded (nullptr if missing).
+   * @return boost::json::value*
+   */
+  boost::json::value *array_node() {
+    if (JsonContext::isArray(*m_ctx.top().second)) {
+      return m_ctx.top().second.get();
+    }
+    m_ctx.pop();
+    boost::system::error_code ec;
+    boost::json::value *pxp = m_ctx.top().second->find_pointer("/px/" + m_ctx.currentTag(), ec);
+    return ec ? nullptr : pxp;
+  }
+
+  /**
+   * @brief Non-owning pointer to a node of the loaded tree, pushed on the context without copy (the node outlives its
+   * load). The loaded tree is only read.
+   * @param val
+   * @return std::shared_ptr<json::value>
+   */
+  static std::shared_ptr<json::value> view(const boost::json::value &val) {
+    return std::shared_ptr<json::value>(std::shared_ptr<json::value>(), const_cast<json::value *>(&val));
+  }
+
+  /**
+   * @brief Json array element, pushed on the context without copy (the array outlives the element load).
+   * @param index
+   * @param val
+   */
+  void push_element(size_t index, const boost::json::value &val) { m_ctx.push(std::to_string(index), view(val)); }
+
+  /**
+   * @brief Load the array elements [first, last) into existing objects.
+   * @tparam It
+   * @param out
+   * @param array
+   * @param first
+   * @param last
+   */
+  template <typename It> void load_range(It out, boost::json::array &array, size_t first, size_t last) {
+    using T = typename std::iterator_traits<It>::value_type;
+    for (size_t index = first; index < last; index++, ++out) {
+      if constexpr ((std::is_class<T>::value && !detail::is_json_string<T>::value) || std::is_pointer<T>::value) {
+        push_element(index, array[index]);
+        load(*out);
+        m_ctx.pop();
+      } else if constexpr (std::is_same<T, bool>::value) {
+        // std::vector<bool> references are proxies.
+        *out = get<T>(array[index]);
+      } else {
+        assign(*out, array[index]);
+      }
+    }
+  }
+
+  /**
+   * @brief Ranged loads (JsonIndex): load the elements holding class information before the range, discarded.
+   * @tparam T
+   */
+  template <typename T> void load_class_elements() {
+    m_class_elements_of = nullptr;
+    if constexpr (std::is_class<T>::value && !detail::is_json_string<T>::value) {
+      for (size_t index = 0; index < m_class_elements.size(); index++) {
+        T item;
+        load_item(item, m_class_elements[index], index);
+      }
+    }
+  }
+
+  /**
+   * @brief Load one array element in place.
+   * @tparam T
+   * @param item
+   * @param val
+   * @param index
+   */
+  template <typename T> void load_item(T &item, const boost::json::value &val, size_t index) {
+    push_element(index, val);
+    load(item);
+    m_ctx.pop();
+  }
+
+  /**
+   * @brief Row of a json_columnar array being loaded: pushed on the context as an empty object, its members are read
+   * in place from the columns (not rebuilt).
+   */
+  struct columns_row {
+    json_iarchive &ar;
+    const boost::json::array &keys;
+    const boost::json::array &values;
+    const size_t index;
+    /**
+     * @brief Column following the previous match.
+     */
+    size_t cursor = 0;
+    const boost::json::value node = boost::json::object();
+    columns_row *const outer;
+    columns_row(json_iarchive &archive, const boost::json::array &k, const boost::json::array &v, size_t i)
+        : ar(archive), keys(k), values(v), index(i), outer(std::exchange(archive.m_row, this)) {}
+    columns_row(const columns_row &) = delete;
+    columns_row &operator=(const columns_row &) = delete;
+    ~columns_row() { ar.m_row = outer; }
+  };
+
+  /**
+   * @brief Load one row of a json_columnar array in place.
+   * @tparam T
+   * @param item
+   * @param keys
+   * @param values
+   * @param index
+   */
+  template <typename T>
+  void load_row(T &item, const boost::json::array &keys, const boost::json::array &values, size_t index) {
+    columns_row row(*this, keys, values, index);
+    m_ctx.push(std::to_string(index), view(row.node));
+    load(item);
+    m_ctx.pop();
+  }
+
+  /**
+   * @brief Load the elements of a vector of class objects on the thread pool, into pre-sized storage.
+   *
+   * The first element and the first chunk are loaded by this archive. Other chunks are loaded by detached archives,
+   * each one loading the first element beforehand (discarded) to register the same class information.
+   * A worker stops at the first element holding class information (tracking, object ids, pointers...): such
+   * elements, and all the following ones, are left to the sequential load.
+   * @tparam T
+   * @tparam Metadata Callable returning true if the i-th element holds class information.
+   * @tparam Load Callable loading the i-th element with an archive.
+   * @param value
+   * @param size
+   * @param metadata
+   * @param load_at
+   * @return size_t Number of loaded elements.
+   */
+  template <typename T, typename Metadata, typename Load>
+  size_t load_array_parallel(std::vector<T> &value, size_t size, const Metadata &metadata, const Load &load_at) {
+    const unsigned int flags = this->get_flags() & ~static_cast<unsigned int>(json_parallel);
+    const boost::json::array *string_table = m_ctx.stringTable();
+    ThreadPool &pool = ThreadPool::instance();
+    const size_t chunks = std::max<size_t>(1, std::min(pool.size() + 1, (size - 1) / MinParallelChunk));
+    const size_t chunk = (size - 1 + chunks - 1) / chunks;
+    value.resize(size);
+    T *data = value.data();
+
+    std::vector<std::pair<size_t, std::future<size_t>>> parts;
+    for (size_t first = 1 + chunk; first < size; first += chunk) {
+      const size_t last = std::min(size, first + chunk);
+      parts.emplace_back(first, pool.submit([&metadata, &load_at, data, first, last, flags, string_table]() {
+        json_iarchive ar(flags, string_table);
+        T warmup;
+        load_at(ar, warmup, 0);
+        size_t i = first;
+        for (; i < last; i++) {
+          if (metadata(i)) {
+            break;
+          }
+          load_at(ar, data[i], i);
+        }
+        return i - first;
+      }));
+    }
+
+    size_t index = 0;
+    std::exception_ptr error;
+    try {
+      for (; index < std::min(size, 1 + chunk); index++) {
+        load_at(*this, data[index], index);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    bool contiguous = !error;
+    for (auto &part : parts) {
+      try {
+        size_t loaded = part.second.get();
+        if (contiguous && part.first == index) {
+          index += loaded;
+          contiguous = (part.first + loaded == std::min(size, part.first + chunk));
+        }
+      } catch (...) {
+        contiguous = false;
+      }
+    }
+    value.resize(index);
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return index;
+  }
+
+  /**
+   * @brief Get raw value, resolving string references.
+   * @tparam T
+   * @param val
+   * @return T
+   */
+  template <typename T> T get(const boost::json::value &val) {
+    if constexpr (std::is_same<T, std::string_view>::value || std::is_same<T, std::string>::value) {
+      // std::string_view: view of the loaded tree, or of its string table.
+      return JsonContext::get<T>(m_ctx.resolve(val));
+    } else {
+      return JsonContext::get<T>(val);
+    }
+  }
+
+  /**
+   * @brief Assign raw value to an existing target, resolving string references (strings reuse their capacity).
+   * @tparam T
+   * @param target
+   * @param val
+   */
+  template <typename T> void assign(T &target, const boost::json::value &val) {
+    if constexpr (std::is_same<T, std::string>::value) {
+      JsonContext::assign(target, m_ctx.resolve(val));
+    } else {
+      target = get<T>(val);
+    }
+  }
+
   /**
    * @brief Json Root Value.
    */
   boost::json::value root_value;
+  /**
+   * @brief Ranged loads (JsonIndex): elements holding class information before the range, loaded before the array
+   * they belong to.
+   */
+  boost::json::array m_class_elements;
+  const boost::json::value *m_class_elements_of = nullptr;
+  /**
+   * @brief json_columnar row being loaded (nullptr if none).
+   */
+  columns_row *m_row = nullptr;
+  /**
+   * @brief Shared document read by this archive (views only).
+   */
+  std::shared_ptr<const JsonDocument> m_document;
+  /**
+   * @brief Loaded Json value: root_value, or a subtree of the shared document.
+   */
+  const boost::json::value *m_input = &root_value;
   /**
    * @brief JsonContext. Using a stack to know the current "location in the Json tree".
    */
@@ -188,6 +739,14 @@ private:
    * @brief Storage for shared pointers (std::shared_ptr).
    */
   std::unordered_map<int64_t, std::shared_ptr<void>> _shared_hack;
+  /**
+   * @brief Minimum number of elements loaded by a worker thread.
+   */
+  static constexpr size_t MinParallelChunk = 64;
+  /**
+   * @brief Minimum number of elements for a vector/array to be loaded in parallel.
+   */
+  size_t m_parallel_threshold = 4096;
 };
 
 } // namespace archive
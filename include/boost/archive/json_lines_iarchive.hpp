@@ -0,0 +1,174 @@
+#ifndef BOOST_JSON_ARCHIVE_LINES_IARCHIVE_H
+#define BOOST_JSON_ARCHIVE_LINES_IARCHIVE_H
+
+// C++ Standard Library
+#include <deque>
+#include <future>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost Archive JSON
+#include "boost/ThreadPool.hpp"
+#include "boost/archive/json_iarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+/**
+ * @brief JSON Lines input archive: reads a stream of Json documents, one per line, record by record.
+ *
+ * The stream is read by blocks and split on newlines, so memory use is bounded by the longest record (not by the
+ * stream size). Each record is loaded by its own json_iarchive. Blank lines are skipped.
+ */
+class BOOST_SYMBOL_EXPORT json_lines_iarchive {
+public:
+  /**
+   * @brief Size of the blocks read from the input stream.
+   */
+  static constexpr size_t BlockSize = 64 * 1024;
+
+  /**
+   * @brief Construct a new JSON Lines input archive.
+   * @param is
+   * @param flags Flags of the records archives.
+   */
+  explicit json_lines_iarchive(std::istream &is, unsigned int flags = 0);
+
+  json_lines_iarchive(const json_lines_iarchive &) = delete;
+  json_lines_iarchive &operator=(const json_lines_iarchive &) = delete;
+
+  /**
+   * @brief Load the next record.
+   * @tparam T
+   * @param nvp
+   * @return true if a record was loaded
+   * @return false at end of stream
+   */
+  template <class T> bool next(const boost::serialization::nvp<T> &nvp) {
+    if (!next_line(m_line)) {
+      return false;
+    }
+    load_record(m_line, nvp, m_flags);
+    return true;
+  }
+
+  /**
+   * @brief Load the next record. Throws at end of stream.
+   * @tparam T
+   * @param nvp
+   * @return json_lines_iarchive&
+   */
+  template <class T> json_lines_iarchive &operator>>(const boost::serialization::nvp<T> &nvp) {
+    if (!next(nvp)) {
+      throw std::runtime_error("No more Json Lines record !");
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Load all the remaining records on the thread pool, and hand them over in stream order.
+   * At most (pool size + 1) batches are held in memory at once.
+   * @tparam T Record type (default constructible).
+   * @tparam F Callable taking a T&&, called on the calling thread.
+   * @param name Records NVP name.
+   * @param f
+   * @param batch Number of records loaded by a pool task.
+   * @return size_t Number of loaded records.
+   */
+  template <class T, class F> size_t for_each(const char *name, F &&f, size_t batch = 256) {
+    ThreadPool &pool = ThreadPool::instance();
+    // Shared by the tasks: a task still queued when this function throws must not read a destroyed name.
+    const auto nvp_name = std::make_shared<const std::string>(name);
+    const unsigned int flags = m_flags;
+    std::deque<std::future<std::vector<T>>> pending;
+    // Tasks are waited for on every exit path (failed record, callback or input stream error).
+    struct drain {
+      std::deque<std::future<std::vector<T>>> &pending;
+      ~drain() {
+        for (auto &p : pending) {
+          if (p.valid()) {
+            p.wait();
+          }
+        }
+      }
+    } drain_pending{pending};
+    size_t count = 0;
+    bool end = false;
+    for (;;) {
+      while (!end && pending.size() <= pool.size()) {
+        std::vector<std::string> lines;
+        lines.reserve(batch);
+        while (lines.size() < batch && next_line(m_line)) {
+          lines.push_back(std::move(m_line));
+        }
+        end = lines.size() < batch;
+        if (lines.empty()) {
+          break;
+        }
+        pending.push_back(pool.submit([lines = std::move(lines), nvp_name, flags]() {
+          std::vector<T> records(lines.size());
+          for (size_t i = 0; i < lines.size(); i++) {
+            load_record(lines[i], boost::serialization::make_nvp(nvp_name->c_str(), records[i]), flags);
+          }
+          return records;
+        }));
+      }
+      if (pending.empty()) {
+        return count;
+      }
+      std::vector<T> records = pending.front().get();
+      pending.pop_front();
+      for (auto &record : records) {
+        f(std::move(record));
+      }
+      count += records.size();
+    }
+  }
+
+private:
+  /**
+   * @brief Load a record with a json_iarchive.
+   * @tparam T
+   * @param line
+   * @param nvp
+   * @param flags
+   */
+  template <class T> static void load_record(const std::string &line, const boost::serialization::nvp<T> &nvp, unsigned int flags) {
+    boost::system::error_code ec;
+    boost::json::value root = boost::json::parse(line, ec);
+    if (ec) {
+      throw std::runtime_error("Json Lines record is not Json Friendly...");
+    }
+    json_iarchive ar(std::move(root), flags);
+    ar >> nvp;
+  }
+
+  /**
+   * @brief Read the next non blank line.
+   * @param line
+   * @return true
+   * @return false at end of stream
+   */
+  bool next_line(std::string &line);
+
+  std::istream &m_is;
+  unsigned int m_flags;
+  /**
+   * @brief Read blocks (the unread part starts at m_pos).
+   */
+  std::string m_buffer;
+  size_t m_pos = 0;
+  /**
+   * @brief Position where to resume the newline search.
+   */
+  size_t m_scan = 0;
+  bool m_eof = false;
+  std::string m_line;
+};
+
+} // namespace archive
+} // namespace boost
+
+#endif // BOOST_JSON_ARCHIVE_LINES_IARCHIVE_H
@@ -0,0 +1,131 @@
+#ifndef BOOST_JSON_ARCHIVE_LINES_OARCHIVE_H
+#define BOOST_JSON_ARCHIVE_LINES_OARCHIVE_H
+
+// C++ Standard Library
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+
+// Boost Archive JSON
+#include "boost/JsonWriter.hpp"
+#include "boost/ThreadPool.hpp"
+#include "boost/archive/json_oarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+/**
+ * @brief JSON Lines output archive: each saved NVP is written as one compact Json document per line.
+ *
+ * Each record is saved by its own json_oarchive, with its own class information and tracked objects (so it can be
+ * read back alone by a json_iarchive), then written as soon as all the records before it are written. Records can
+ * be saved concurrently from several threads (operator<<) or on the thread pool (post): they are written in the
+ * order they were started.
+ */
+class BOOST_SYMBOL_EXPORT json_lines_oarchive {
+public:
+  /**
+   * @brief Construct a new JSON Lines output archive.
+   * @param os
+   * @param flags Flags of the records archives.
+   */
+  explicit json_lines_oarchive(std::ostream &os, unsigned int flags = 0);
+  /**
+   * @brief Destroy the JSON Lines output archive. Waits for posted records, errors are dropped (call flush()).
+   */
+  ~json_lines_oarchive();
+
+  json_lines_oarchive(const json_lines_oarchive &) = delete;
+  json_lines_oarchive &operator=(const json_lines_oarchive &) = delete;
+
+  /**
+   * @brief Save one record on the calling thread.
+   * @tparam T
+   * @param nvp
+   * @return json_lines_oarchive&
+   */
+  template <class T> json_lines_oarchive &operator<<(const boost::serialization::nvp<T> &nvp) {
+    const uint64_t ticket = take_ticket();
+    std::optional<boost::json::value> record;
+    try {
+      record = save_record(nvp);
+    } catch (...) {
+      complete(ticket, std::nullopt);
+      throw;
+    }
+    complete(ticket, std::move(record));
+    return *this;
+  }
+
+  /**
+   * @brief Save one record (a copy of value) on the thread pool.
+   * Errors are reported by flush().
+   * @tparam T
+   * @param name
+   * @param value
+   */
+  template <class T> void post(const char *name, T value) {
+    const uint64_t ticket = take_ticket();
+    try {
+      ThreadPool::instance().submit([this, ticket, name = std::string(name), value = std::move(value)]() mutable {
+        std::optional<boost::json::value> record;
+        try {
+          record = save_record(boost::serialization::make_nvp(name.c_str(), value));
+        } catch (...) {
+          fail(std::current_exception());
+        }
+        complete(ticket, std::move(record));
+      });
+    } catch (...) {
+      // The record is not written: the following ones must not wait for it.
+      complete(ticket, std::nullopt);
+      throw;
+    }
+  }
+
+  /**
+   * @brief Wait for all the started records to be written, then flush the output stream.
+   * Rethrows the first error raised by a posted record, or throws on output stream failure.
+   */
+  void flush();
+
+private:
+  template <class T> boost::json::value save_record(const boost::serialization::nvp<T> &nvp) {
+    json_oarchive ar(m_flags);
+    ar << nvp;
+    return ar.m_ctx.takeDocument();
+  }
+
+  uint64_t take_ticket();
+  void complete(uint64_t ticket, std::optional<boost::json::value> record);
+  void fail(std::exception_ptr error);
+  void wait(std::unique_lock<std::mutex> &lock);
+
+  std::ostream &m_os;
+  unsigned int m_flags;
+  JsonWriter m_writer;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  /**
+   * @brief Next record ticket.
+   */
+  uint64_t m_tickets = 0;
+  /**
+   * @brief Ticket of the next record to write.
+   */
+  uint64_t m_written = 0;
+  /**
+   * @brief Completed records waiting for the previous ones (nullopt: failed record).
+   */
+  std::map<uint64_t, std::optional<boost::json::value>> m_ready;
+  std::exception_ptr m_error;
+};
+
+} // namespace archive
+} // namespace boost
+
+#endif // BOOST_JSON_ARCHIVE_LINES_OARCHIVE_H
@@ -2,17 +2,30 @@
 #define BOOST_JSON_ARCHIVE_OARCHIVE_H
 
 // C++ Standard Library
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <future>
 #include <iterator>
+#include <memory>
 #include <ostream>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 // Boost
 #include <boost/archive/detail/common_oarchive.hpp>
 #include <boost/archive/detail/register_archive.hpp>
 
 // Boost Archive JSON
+#include "boost/JsonCbor.hpp"
 #include "boost/JsonContext.hpp"
+#include "boost/JsonDocument.hpp"
+#include "boost/JsonIndex.hpp"
+#include "boost/JsonSink.hpp"
+#include "boost/ThreadPool.hpp"
 #include "boost/archive/TraitsDetailsHelper.hpp"
+#include "boost/archive/json_archive_flags.hpp"
 
 namespace boost {
 namespace archive {
@@ -20,51 +33,144 @@ namespace archive {
 class BOOST_SYMBOL_EXPORT json_oarchive : public detail::common_oarchive<json_oarchive> {
 public:
   explicit json_oarchive(std::ostream &os, unsigned int = 0, const bool prettify = false);
+  /**
+   * @brief Construct a new Json Output Archive writing to a sink.
+   * @param sink
+   * @param flags
+   * @param prettify
+   */
+  explicit json_oarchive(JsonSink &sink, unsigned int flags = 0, const bool prettify = false);
 
+  /**
+   * @brief Destroy the Json Output Archive. Calls finish() if needed, errors are dropped.
+   */
   ~json_oarchive();
 
+  /**
+   * @brief Write the saved top-level members to the output stream (or sink), then flush it.
+   * Throws on output failure.
+   */
+  void flush();
+  /**
+   * @brief Write the whole document to the output stream (or sink), then flush it. Nothing can be saved afterwards.
+   * Throws on output failure.
+   */
+  void finish();
+  /**
+   * @brief Exact number of bytes finish() will write (to reserve the output beforehand).
+   * Not available once top-level members were written (flush() or flush threshold).
+   * @return size_t
+   */
+  size_t measure();
+  /**
+   * @brief Write the saved document as a binary JsonSnapshot to another sink (a load-speed cache of the Json output).
+   * Not available once top-level members were written (flush() or flush threshold).
+   * @param sink
+   */
+  void write_snapshot(JsonSink &sink);
+  /**
+   * @brief XXH64 digest of the canonical Json text of the saved document (see json_canonical), nothing is written.
+   * Equal to the DigestSink digest of a json_canonical archive output.
+   * Not available once top-level members were written (flush() or flush threshold).
+   * @return uint64_t
+   */
+  uint64_t digest();
+  /**
+   * @brief Write each top-level member as soon as it is saved, instead of the whole document at finish().
+   * Output is handed to the stream by chunks of (about) threshold bytes. To be set before saving anything.
+   * @param threshold Chunk size in bytes (0: disabled).
+   */
+  void set_flush_threshold(size_t threshold) { m_flush_threshold = threshold; }
+  /**
+   * @brief Record the byte offsets of the top-level members, and of every index.stride()-th element of the top-level
+   * arrays, into a sidecar index (complete once finish() returned). To be set before saving anything.
+   * @param index
+   */
+  void set_index(JsonIndex &index) { m_index = &index; }
+  /**
+   * @brief Write an RFC 7386 merge patch against a baseline document (e.g. the previous output) instead of the whole
+   * document. Members equal to the baseline are dropped as soon as they are saved, members missing from the output are
+   * written as null, arrays are written whole when changed. To be set before saving anything; the baseline must outlive
+   * the archive.
+   * Not available with json_string_table or json_elide_defaults. Objects carrying class information are kept (possibly
+   * empty), so that json_iarchive::load_patch() meets it in order; tracked objects must not be shared across members.
+   * @param baseline
+   */
+  void set_baseline(const boost::json::value &baseline);
+  /**
+   * @brief Write an RFC 7386 merge patch against a parsed baseline document (kept by the archive).
+   * @param baseline
+   */
+  void set_baseline(std::shared_ptr<const JsonDocument> baseline);
+
   template <typename T> void save_fundamental(const T &value) {
+    if constexpr (detail::is_json_string<T>::value) {
+      if (this->get_flags() & json_string_table) {
+        if constexpr (std::is_same<T, std::string>::value) {
+          save_fundamental(m_ctx.intern(value));
+        } else {
+          save_fundamental(m_ctx.intern(std::string(value)));
+        }
+        return;
+      }
+    }
     if (m_ctx.empty()) {
       boost::json::object o;
-      o[m_ctx.currentTag()] = value;
+      o[m_ctx.currentTag()] = json_scalar(value);
       m_ctx.setRoot(m_ctx.currentTag(), std::make_shared<boost::json::value>(o));
     } else if (m_ctx.top().second->is_object()) {
       JsonContext::emplace(*m_ctx.top().second, value);
     } else if (m_ctx.top().second->is_array()) {
-      m_ctx.top().second->as_array().push_back(boost::json::value(value));
+      m_ctx.top().second->as_array().push_back(boost::json::value(json_scalar(value)));
+    }
+  }
+
+  /**
+   * @brief Value accepted by boost::json::value (strings are referenced, not copied).
+   * @tparam T
+   * @param value
+   * @return decltype(auto)
+   */
+  template <typename T> static decltype(auto) json_scalar(const T &value) {
+    if constexpr (detail::is_json_string<T>::value) {
+      return boost::json::string_view(value.data(), value.size());
+    } else {
+      return (value);
     }
   }
 
   template <typename T>
   std::enable_if_t<detail::is_std_vector<T>::type::value or detail::is_fixed_size_array<T>::type::value>
   save_array(const T &value) {
+    if constexpr (std::is_same<typename T::value_type, bool>::value) {
+      if (this->get_flags() & json_packed_bools) {
+        JsonContext::packBits(value, *m_ctx.current().second);
+        return;
+      }
+    }
     boost::json::array &array = m_ctx.current().second->get_array();
-    int index = 0;
-    for (const auto &v : value) {
-      if constexpr ((std::is_class<typename T::value_type>::value && !std::is_same<typename T::value_type, std::string>::value) ||
-                    std::is_pointer<typename T::value_type>::value) {
-        if constexpr ((detail::is_std_vector<typename T::value_type>::value or
-                       detail::is_fixed_size_array<typename T::value_type>::value) or
-                      detail::is_fixed_size_old_school_array<typename T::value_type>::value) {
-          m_ctx.push(std::to_string(index), std::make_shared<json::value>(boost::json::array()));
-        } else {
-          m_ctx.push(std::to_string(index), std::make_shared<json::value>(boost::json::object()));
-        }
-        save(v);
-        array.push_back(*m_ctx.top().second);
-      } else {
-        save(v);
+    size_t index = 0;
+    if constexpr (detail::is_json_object<typename T::value_type>::value) {
+      if ((this->get_flags() & json_parallel) && !(this->get_flags() & json_string_table) &&
+          value.size() >= m_parallel_threshold) {
+        index = save_array_parallel(value, array);
       }
-      if constexpr ((std::is_class<typename T::value_type>::value && !std::is_same<typename T::value_type, std::string>::value) ||
-                    std::is_pointer<typename T::value_type>::value) {
-        m_ctx.pop();
+    }
+    for (; index < value.size(); index++) {
+      save_element(*(std::begin(value) + index), index, array);
+    }
+    if constexpr (detail::is_json_object<typename T::value_type>::value) {
+      if ((this->get_flags() & json_columnar) && !array.empty()) {
+        boost::json::value columnar;
+        if (JsonContext::toColumns(array, columnar)) {
+          *m_ctx.current().second = std::move(columnar);
+        }
       }
-      index++;
     }
   }
 
   template <typename T> void save(const T &value) {
-    if constexpr (std::is_fundamental<T>::value || std::is_same<T, std::string>::value) {
+    if constexpr (std::is_fundamental<T>::value || detail::is_json_string<T>::value) {
       save_fundamental(value);
     } else if constexpr (std::is_enum<T>::value) {
       save_fundamental(static_cast<int64_t>(value));
@@ -105,29 +211,55 @@ public:
    *                              NVP                                      *
    *************************************************************************/
   template <class T> void save_override(const boost::serialization::nvp<T> &kv) {
+    if constexpr (std::is_arithmetic<T>::value || std::is_enum<T>::value || detail::is_json_string<T>::value) {
+      if ((this->get_flags() & json_elide_defaults) && !m_ctx.empty() && m_ctx.top().second->is_object() &&
+          is_default(kv.const_value())) {
+        return;
+      }
+    }
+    // Nesting level, context stack and baseline frames are restored when saving the value throws.
+    struct nesting {
+      json_oarchive &ar;
+      const size_t context;
+      const size_t frames;
+      const int exceptions = std::uncaught_exceptions();
+      explicit nesting(json_oarchive &a) : ar(a), context(a.m_ctx.size()), frames(a.m_baseline_frames.size()) { ar.m_depth++; }
+      ~nesting() {
+        ar.m_depth--;
+        if (std::uncaught_exceptions() > exceptions) {
+          while (ar.m_ctx.size() > std::max<size_t>(context, 1)) {
+            ar.m_ctx.pop();
+          }
+          ar.m_baseline_frames.resize(std::min(frames, ar.m_baseline_frames.size()));
+        }
+      }
+    } level{*this};
     boost::json::object o;
     std::shared_ptr<boost::json::value> root_ptr = nullptr;
-    std::string name = kv.name() ? kv.name() : "px";
+    const char *name = kv.name() ? kv.name() : "px";
+    bool in_root = false;
     if (!m_ctx.empty()) {
       root_ptr = m_ctx.top().second;
       boost::json::value &root = *root_ptr;
       if (root.is_object()) {
+        boost::json::object::iterator member;
         if constexpr (detail::is_std_vector<T>::value || detail::is_fixed_size_array<T>::value || detail::is_std_map<T>::value) {
-          root.as_object().emplace(name, boost::json::array());
+          member = root.as_object().emplace(name, boost::json::array()).first;
         } else {
-          root.as_object().emplace(name, o);
+          member = root.as_object().emplace(name, o).first;
         }
-        m_ctx.push(name, std::make_shared<json::value>(root.as_object()[name]));
+        m_ctx.push(name, std::make_shared<json::value>(member->value()));
       } else if (root.is_array()) {
         root.as_array().push_back(boost::json::object{});
         m_ctx.push(name, std::make_shared<json::value>(root.as_array().at(root.as_array().size() - 1)));
       }
-    } else if constexpr (!std::is_same<T, std::string>::value && !detail::is_std_vector<T>::value &&
-                         !detail::is_std_map<T>::value && !detail::is_fixed_size_array<T>::value &&
-                         (std::is_class<T>::value || std::is_pointer<T>::value)) {
+      enter_baseline(root.is_object(), name);
+    } else if constexpr (detail::is_root_object<T>::value) {
       o[demangle(typeid(T).name())] = kv.name();
       m_ctx.setRoot(name, std::make_shared<boost::json::value>(o));
       root_ptr = m_ctx.root();
+      // Members are saved into the root object itself.
+      in_root = true;
     } else if constexpr (detail::is_std_vector<T>::value || detail::is_fixed_size_array<T>::value ||
                          detail::is_std_map<T>::value) {
       boost::json::array a;
@@ -135,8 +267,10 @@ public:
       m_ctx.setRoot(name, std::make_shared<boost::json::value>(o));
       m_ctx.push(name, std::make_shared<json::value>(a));
       root_ptr = m_ctx.root();
+      enter_baseline(true, name);
     } else {
       m_ctx.setCurrentTag(kv.name());
+      enter_baseline(true, name);
     }
     this->save(kv.const_value());
     if (root_ptr && m_ctx.current().second != root_ptr) {
@@ -150,9 +284,15 @@ public:
         }
       }
     }
+    if (!in_root) {
+      leave_baseline(root_ptr ? root_ptr.get() : m_ctx.root().get(), name);
+    }
     if (m_ctx.size() > 1) {
       m_ctx.pop();
     }
+    if (m_depth == 1 && m_flush_threshold) {
+      write_members();
+    }
   }
 
   /*************************************************************************
@@ -167,10 +307,217 @@ public:
   void save_override(const class_id_reference_type &t);
   void save_override(const tracking_type &t);
 
+  /**
+   * @brief Minimum number of elements for a vector/array to be saved in parallel (json_parallel flag).
+   * @param threshold
+   */
+  void set_parallel_threshold(size_t threshold) { m_parallel_threshold = threshold; }
+
 private:
+  friend class json_lines_oarchive;
+  friend class cbor_oarchive;
+
+  /**
+   * @brief Encoding of the written document.
+   */
+  enum class encoding { json, cbor };
+
+  /**
+   * @brief Construct a detached archive (no output stream), used to save parts of the Json tree on worker threads.
+   * @param flags
+   */
+  explicit json_oarchive(unsigned int flags);
+
+  /**
+   * @brief Write the root object members saved so far, and drop them from the Json tree.
+   */
+  void write_members();
+  /**
+   * @brief Return true if the document is written as a whole at finish() (binary encodings, canonical Json).
+   * @return true
+   * @return false
+   */
+  bool whole_document() const {
+    return m_encoding != encoding::json || (this->get_flags() & (json_snapshot | json_canonical));
+  }
+  /**
+   * @brief Write the whole document with a binary encoding, or as canonical Json text.
+   * @param document
+   * @param sink
+   */
+  void write_encoded(const boost::json::value &document, JsonSink &sink) const;
+  /**
+   * @brief Merge patch: start a member of the current Json value (its baseline is looked up by name in objects).
+   * @param in_object
+   * @param name
+   */
+  void enter_baseline(bool in_object, boost::json::string_view name) {
+    if (m_baseline) {
+      push_baseline(in_object, name);
+    }
+  }
+  /**
+   * @brief Merge patch: end a member, dropped from its container if equal to its baseline.
+   * @param container
+   * @param name
+   */
+  void leave_baseline(boost::json::value *container, boost::json::string_view name) {
+    if (m_baseline) {
+      pop_baseline(container, name);
+    }
+  }
+  void push_baseline(bool in_object, boost::json::string_view name);
+  void pop_baseline(boost::json::value *container, boost::json::string_view name);
+  /**
+   * @brief Merge patch: baseline of a member, and names of its members saved so far.
+   */
+  struct baseline_frame {
+    const boost::json::value *base = nullptr;
+    std::vector<std::string> saved;
+  };
+  /**
+   * @brief Merge patch: write the baseline members of an object neither saved nor present as null.
+   * @param object
+   * @param frame
+   * @return true if a member was added
+   */
+  static bool delete_missing(boost::json::object &object, const baseline_frame &frame);
+
+  /**
+   * @brief Return true if the value equals a default constructed one (negative zeros do not: they would be loaded as
+   * zeros).
+   * @tparam T
+   * @param value
+   * @return true
+   * @return false
+   */
+  template <typename T> static bool is_default(const T &value) {
+    if constexpr (std::is_floating_point<T>::value) {
+      return value == T() && !std::signbit(value);
+    } else {
+      return value == T();
+    }
+  }
+
+  template <typename V> void save_element(const V &v, size_t index, boost::json::array &array) {
+    if constexpr ((std::is_class<V>::value && !detail::is_json_string<V>::value) || std::is_pointer<V>::value) {
+      if constexpr ((detail::is_std_vector<V>::value or detail::is_fixed_size_array<V>::value) or
+                    detail::is_fixed_size_old_school_array<V>::value) {
+        m_ctx.push(std::to_string(index), std::make_shared<json::value>(boost::json::array()));
+      } else {
+        m_ctx.push(std::to_string(index), std::make_shared<json::value>(boost::json::object()));
+      }
+      save(v);
+      array.push_back(*m_ctx.top().second);
+      m_ctx.pop();
+    } else {
+      save(v);
+    }
+  }
+
+  /**
+   * @brief Save the elements of a vector/array of class objects on the thread pool.
+   *
+   * The first element is saved by this archive first: when it holds tracked objects or pointers (object ids numbered
+   * by the archive), nothing is submitted and the array is saved sequentially. Otherwise the first chunk is saved by
+   * this archive and other chunks by detached archives, each one saving the first element beforehand (discarded) to
+   * register the same class information. Parts holding class information anyway (a class first met after the first
+   * element) would not be identical to a sequential save: they are dropped and saving goes on sequentially.
+   * @tparam T
+   * @param value
+   * @param array
+   * @return size_t Number of saved elements.
+   */
+  template <typename T> size_t save_array_parallel(const T &value, boost::json::array &array) {
+    const unsigned int flags = this->get_flags() & ~static_cast<unsigned int>(json_parallel);
+    const size_t size = value.size();
+    ThreadPool &pool = ThreadPool::instance();
+    const size_t chunks = std::max<size_t>(1, std::min(pool.size() + 1, (size - 1) / MinParallelChunk));
+    const size_t chunk = (size - 1 + chunks - 1) / chunks;
+    auto begin = std::begin(value);
+    save_element(*begin, 0, array);
+    if (JsonContext::hasTracking(array.back())) {
+      return 1;
+    }
+
+    std::vector<std::future<boost::json::array>> parts;
+    for (size_t first = 1 + chunk; first < size; first += chunk) {
+      const size_t last = std::min(size, first + chunk);
+      parts.push_back(pool.submit([begin, first, last, flags]() {
+        json_oarchive ar(flags);
+        ar.m_ctx.setRoot("", std::make_shared<boost::json::value>(boost::json::array()));
+        boost::json::array rows;
+        ar.save_element(*begin, 0, rows);
+        rows.clear();
+        rows.reserve(last - first);
+        for (size_t i = first; i < last; i++) {
+          ar.save_element(*(begin + i), i, rows);
+        }
+        return rows;
+      }));
+    }
+
+    size_t index = 1;
+    std::exception_ptr error;
+    try {
+      for (; index < std::min(size, 1 + chunk); index++) {
+        save_element(*(begin + index), index, array);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    bool identical = !error;
+    for (auto &part : parts) {
+      try {
+        boost::json::array rows = part.get();
+        identical = identical && !JsonContext::hasMetadata(rows);
+        if (identical) {
+          for (auto &row : rows) {
+            array.push_back(std::move(row));
+          }
+          index += rows.size();
+        }
+      } catch (...) {
+        identical = false;
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return index;
+  }
+
+  /**
+   * @brief Minimum number of elements saved by a worker thread.
+   */
+  static constexpr size_t MinParallelChunk = 64;
+
   JsonContext m_ctx;
-  std::ostream &os_;
+  /**
+   * @brief Sink owned by the archive (std::ostream output).
+   */
+  std::unique_ptr<JsonSink> m_stream_sink;
+  JsonSink *sink_;
   bool prettify_ = false;
+  size_t m_parallel_threshold = 4096;
+  /**
+   * @brief Writer of the root object members (created by the first write_members()).
+   */
+  std::unique_ptr<JsonWriter> m_writer;
+  size_t m_flush_threshold = 0;
+  JsonIndex *m_index = nullptr;
+  encoding m_encoding = encoding::json;
+  const boost::json::value *m_baseline = nullptr;
+  std::shared_ptr<const JsonDocument> m_baseline_document;
+  /**
+   * @brief Merge patch: one frame per NVP nesting level, the root document first.
+   */
+  std::vector<baseline_frame> m_baseline_frames;
+  /**
+   * @brief NVP nesting level (0: between top-level members).
+   */
+  size_t m_depth = 0;
+  bool m_finished = false;
 };
 
 } // namespace archive
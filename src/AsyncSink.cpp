@@ -0,0 +1,89 @@
+#include "boost/AsyncSink.hpp"
+
+#include <algorithm>
+
+AsyncSink::AsyncSink(JsonSink &target, size_t buffers)
+    : m_target{target}, m_capacity{std::max<size_t>(buffers, 2) - 1}, m_thread{&AsyncSink::run, this} {}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+}
+
+void AsyncSink::write(std::string &buffer) {
+  if (buffer.empty()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() { return m_queue.size() < m_capacity || m_error; });
+  if (m_error) {
+    std::rethrow_exception(m_error);
+  }
+  m_queue.push_back(std::move(buffer));
+  buffer = std::string();
+  if (!m_free.empty()) {
+    buffer.swap(m_free.back());
+    m_free.pop_back();
+  }
+  lock.unlock();
+  m_cv.notify_all();
+}
+
+void AsyncSink::flush() {
+  wait();
+  m_target.flush();
+}
+
+void AsyncSink::finish() {
+  wait();
+  m_target.finish();
+}
+
+void AsyncSink::wait() {
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+    std::swap(error, m_error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void AsyncSink::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+    if (m_queue.empty()) {
+      return;
+    }
+    std::string buffer = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_busy = true;
+    const bool failed = static_cast<bool>(m_error);
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      if (!failed) {
+        m_target.write(buffer);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    buffer.clear();
+    lock.lock();
+    if (error && !m_error) {
+      m_error = error;
+    }
+    if (m_free.size() < m_capacity) {
+      m_free.push_back(std::move(buffer));
+    }
+    m_busy = false;
+    m_cv.notify_all();
+  }
+}
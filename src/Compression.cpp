@@ -0,0 +1,246 @@
+#include "boost/Compression.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef BOOST_JSON_ARCHIVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef BOOST_JSON_ARCHIVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+/**
+ * @brief Size of the compressed blocks handed to the target sink.
+ */
+constexpr size_t CompressedBlockSize = 64 * 1024;
+/**
+ * @brief Maximum size handed to the codec at once (zlib sizes are 32 bits).
+ */
+constexpr size_t MaxCodecChunk = size_t(1) << 30;
+} // namespace
+
+#ifdef BOOST_JSON_ARCHIVE_ZLIB
+
+struct GzipSink::Stream {
+  z_stream z{};
+};
+
+GzipSink::GzipSink(JsonSink &target, int level)
+    : m_target{target}, m_stream{std::make_unique<Stream>()}, m_out(CompressedBlockSize, '\0') {
+  // 15 + 16: maximum window, gzip header and trailer.
+  if (deflateInit2(&m_stream->z, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    throw std::runtime_error("Gzip: compressor initialization failed !");
+  }
+}
+
+GzipSink::~GzipSink() { deflateEnd(&m_stream->z); }
+
+void GzipSink::write(std::string &buffer) {
+  for (size_t pos = 0; pos < buffer.size(); pos += MaxCodecChunk) {
+    encode(buffer.data() + pos, std::min(MaxCodecChunk, buffer.size() - pos), Z_NO_FLUSH);
+  }
+}
+
+void GzipSink::flush() {
+  encode(nullptr, 0, Z_SYNC_FLUSH);
+  m_target.flush();
+}
+
+void GzipSink::finish() {
+  encode(nullptr, 0, Z_FINISH);
+  m_target.finish();
+}
+
+void GzipSink::encode(const char *data, size_t size, int mode) {
+  z_stream &z = m_stream->z;
+  z.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+  z.avail_in = static_cast<uInt>(size);
+  for (;;) {
+    if (m_used == m_out.size()) {
+      drain();
+    }
+    z.next_out = reinterpret_cast<Bytef *>(&m_out[m_used]);
+    z.avail_out = static_cast<uInt>(m_out.size() - m_used);
+    int ret = deflate(&z, mode);
+    m_used = m_out.size() - z.avail_out;
+    if (ret == Z_STREAM_ERROR) {
+      throw std::runtime_error("Gzip: compression failed !");
+    }
+    if (mode == Z_FINISH ? ret == Z_STREAM_END : (z.avail_in == 0 && z.avail_out != 0)) {
+      break;
+    }
+  }
+  if (mode != Z_NO_FLUSH) {
+    drain();
+  }
+}
+
+void GzipSink::drain() {
+  if (m_used == 0) {
+    return;
+  }
+  m_out.resize(m_used);
+  m_target.write(m_out);
+  m_out.clear();
+  m_out.resize(CompressedBlockSize);
+  m_used = 0;
+}
+
+struct GzipSource::Stream {
+  z_stream z{};
+};
+
+GzipSource::GzipSource(JsonSource &source)
+    : m_source{source}, m_stream{std::make_unique<Stream>()}, m_in(CompressedBlockSize, '\0') {
+  // 15 + 32: maximum window, automatic gzip/zlib header detection.
+  if (inflateInit2(&m_stream->z, 15 + 32) != Z_OK) {
+    throw std::runtime_error("Gzip: decompressor initialization failed !");
+  }
+}
+
+GzipSource::~GzipSource() { inflateEnd(&m_stream->z); }
+
+size_t GzipSource::read(char *data, size_t size) {
+  z_stream &z = m_stream->z;
+  size = std::min(size, MaxCodecChunk);
+  z.next_out = reinterpret_cast<Bytef *>(data);
+  z.avail_out = static_cast<uInt>(size);
+  for (;;) {
+    if (z.avail_in == 0 && !m_end) {
+      size_t n = m_source.read(&m_in[0], m_in.size());
+      m_end = (n == 0);
+      z.next_in = reinterpret_cast<Bytef *>(&m_in[0]);
+      z.avail_in = static_cast<uInt>(n);
+    }
+    int ret = inflate(&z, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      // Another gzip member may follow.
+      inflateReset(&z);
+      m_complete = true;
+    } else if (ret == Z_OK) {
+      m_complete = false;
+    } else if (ret != Z_BUF_ERROR) {
+      throw std::runtime_error("Gzip: corrupted data !");
+    }
+    const size_t produced = size - z.avail_out;
+    if (produced > 0) {
+      return produced;
+    }
+    if (m_end && z.avail_in == 0) {
+      if (!m_complete) {
+        throw std::runtime_error("Gzip: truncated data !");
+      }
+      return 0;
+    }
+  }
+}
+
+#endif // BOOST_JSON_ARCHIVE_ZLIB
+
+#ifdef BOOST_JSON_ARCHIVE_ZSTD
+
+struct ZstdSink::Stream {
+  ZSTD_CCtx *ctx = nullptr;
+};
+
+ZstdSink::ZstdSink(JsonSink &target, int level)
+    : m_target{target}, m_stream{std::make_unique<Stream>()}, m_out(CompressedBlockSize, '\0') {
+  m_stream->ctx = ZSTD_createCCtx();
+  if (!m_stream->ctx || ZSTD_isError(ZSTD_CCtx_setParameter(m_stream->ctx, ZSTD_c_compressionLevel, level))) {
+    ZSTD_freeCCtx(m_stream->ctx);
+    throw std::runtime_error("Zstd: compressor initialization failed !");
+  }
+}
+
+ZstdSink::~ZstdSink() { ZSTD_freeCCtx(m_stream->ctx); }
+
+void ZstdSink::write(std::string &buffer) { encode(buffer.data(), buffer.size(), ZSTD_e_continue); }
+
+void ZstdSink::flush() {
+  encode(nullptr, 0, ZSTD_e_flush);
+  m_target.flush();
+}
+
+void ZstdSink::finish() {
+  encode(nullptr, 0, ZSTD_e_end);
+  m_target.finish();
+}
+
+void ZstdSink::encode(const char *data, size_t size, int mode) {
+  ZSTD_inBuffer in{data, size, 0};
+  for (;;) {
+    if (m_used == m_out.size()) {
+      drain();
+    }
+    ZSTD_outBuffer out{&m_out[0], m_out.size(), m_used};
+    size_t remaining = ZSTD_compressStream2(m_stream->ctx, &out, &in, static_cast<ZSTD_EndDirective>(mode));
+    m_used = out.pos;
+    if (ZSTD_isError(remaining)) {
+      throw std::runtime_error(std::string("Zstd: ") + ZSTD_getErrorName(remaining));
+    }
+    if (mode == ZSTD_e_continue ? in.pos == in.size : remaining == 0) {
+      break;
+    }
+  }
+  if (mode != ZSTD_e_continue) {
+    drain();
+  }
+}
+
+void ZstdSink::drain() {
+  if (m_used == 0) {
+    return;
+  }
+  m_out.resize(m_used);
+  m_target.write(m_out);
+  m_out.clear();
+  m_out.resize(CompressedBlockSize);
+  m_used = 0;
+}
+
+struct ZstdSource::Stream {
+  ZSTD_DCtx *ctx = nullptr;
+};
+
+ZstdSource::ZstdSource(JsonSource &source)
+    : m_source{source}, m_stream{std::make_unique<Stream>()}, m_in(ZSTD_DStreamInSize(), '\0') {
+  m_stream->ctx = ZSTD_createDCtx();
+  if (!m_stream->ctx) {
+    throw std::runtime_error("Zstd: decompressor initialization failed !");
+  }
+}
+
+ZstdSource::~ZstdSource() { ZSTD_freeDCtx(m_stream->ctx); }
+
+size_t ZstdSource::read(char *data, size_t size) {
+  ZSTD_outBuffer out{data, size, 0};
+  for (;;) {
+    if (m_inPos == m_inSize && !m_end) {
+      m_inSize = m_source.read(&m_in[0], m_in.size());
+      m_inPos = 0;
+      m_end = (m_inSize == 0);
+    }
+    ZSTD_inBuffer in{m_in.data(), m_inSize, m_inPos};
+    size_t ret = ZSTD_decompressStream(m_stream->ctx, &out, &in);
+    if (ZSTD_isError(ret)) {
+      throw std::runtime_error(std::string("Zstd: ") + ZSTD_getErrorName(ret));
+    }
+    if (in.pos > m_inPos || out.pos > 0) {
+      m_complete = (ret == 0);
+    }
+    m_inPos = in.pos;
+    if (out.pos > 0) {
+      return out.pos;
+    }
+    if (m_end && m_inPos == m_inSize) {
+      if (!m_complete) {
+        throw std::runtime_error("Zstd: truncated data !");
+      }
+      return 0;
+    }
+  }
+}
+
+#endif // BOOST_JSON_ARCHIVE_ZSTD
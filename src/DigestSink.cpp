@@ -0,0 +1,127 @@
+#include "boost/DigestSink.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// XXH64 reads little endian words.
+inline uint64_t read64(const char *p) {
+  const unsigned char *b = reinterpret_cast<const unsigned char *>(p);
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--) {
+    v = (v << 8) | b[i];
+  }
+  return v;
+}
+
+inline uint32_t read32(const char *p) {
+  const unsigned char *b = reinterpret_cast<const unsigned char *>(p);
+  return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+inline uint64_t mixRound(uint64_t acc, uint64_t input) { return rotl(acc + input * Prime2, 31) * Prime1; }
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t val) { return (acc ^ mixRound(0, val)) * Prime1 + Prime4; }
+
+constexpr uint64_t InitialAcc[4] = {Prime1 + Prime2, Prime2, 0, 0 - Prime1};
+} // namespace
+
+void DigestSink::write(std::string &buffer) {
+  update(buffer.data(), buffer.size());
+  if (m_target) {
+    m_target->write(buffer);
+  }
+}
+
+void DigestSink::flush() {
+  if (m_target) {
+    m_target->flush();
+  }
+}
+
+void DigestSink::finish() {
+  if (m_target) {
+    m_target->finish();
+  }
+}
+
+void DigestSink::reset() {
+  m_stripeSize = 0;
+  m_size = 0;
+}
+
+void DigestSink::update(const char *data, size_t size) {
+  if (m_size == 0) {
+    std::memcpy(m_acc, InitialAcc, sizeof(m_acc));
+  }
+  m_size += size;
+  if (m_stripeSize) {
+    const size_t n = std::min(size, sizeof(m_stripe) - m_stripeSize);
+    std::memcpy(m_stripe + m_stripeSize, data, n);
+    m_stripeSize += n;
+    data += n;
+    size -= n;
+    if (m_stripeSize < sizeof(m_stripe)) {
+      return;
+    }
+    for (int i = 0; i < 4; i++) {
+      m_acc[i] = mixRound(m_acc[i], read64(m_stripe + i * 8));
+    }
+    m_stripeSize = 0;
+  }
+  for (; size >= sizeof(m_stripe); data += sizeof(m_stripe), size -= sizeof(m_stripe)) {
+    for (int i = 0; i < 4; i++) {
+      m_acc[i] = mixRound(m_acc[i], read64(data + i * 8));
+    }
+  }
+  if (size) {
+    std::memcpy(m_stripe, data, size);
+  }
+  m_stripeSize = size;
+}
+
+uint64_t DigestSink::digest() const {
+  uint64_t h;
+  if (m_size >= sizeof(m_stripe)) {
+    h = rotl(m_acc[0], 1) + rotl(m_acc[1], 7) + rotl(m_acc[2], 12) + rotl(m_acc[3], 18);
+    for (int i = 0; i < 4; i++) {
+      h = mergeRound(h, m_acc[i]);
+    }
+  } else {
+    h = Prime5;
+  }
+  h += m_size;
+  const char *p = m_stripe;
+  size_t remaining = m_stripeSize;
+  for (; remaining >= 8; p += 8, remaining -= 8) {
+    h = rotl(h ^ mixRound(0, read64(p)), 27) * Prime1 + Prime4;
+  }
+  if (remaining >= 4) {
+    h = rotl(h ^ (uint64_t(read32(p)) * Prime1), 23) * Prime2 + Prime3;
+    p += 4;
+    remaining -= 4;
+  }
+  for (; remaining; p++, remaining--) {
+    h = rotl(h ^ (uint64_t(static_cast<unsigned char>(*p)) * Prime5), 11) * Prime1;
+  }
+  h ^= h >> 33;
+  h *= Prime2;
+  h ^= h >> 29;
+  h *= Prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+uint64_t DigestSink::digest(const char *data, size_t size) {
+  DigestSink sink;
+  sink.update(data, size);
+  return sink.digest();
+}
@@ -0,0 +1,211 @@
+#include "boost/FileSink.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief Maximum number of buffers written by a single pwritev.
+ */
+#ifdef IOV_MAX
+constexpr size_t MaxIov = std::min<size_t>(IOV_MAX, 64);
+#else
+constexpr size_t MaxIov = 16;
+#endif
+
+[[noreturn]] void throwErrno(const char *what) { throw std::runtime_error(std::string(what) + ": " + std::strerror(errno)); }
+} // namespace
+
+FileSink::FileSink(const std::string &path, uint64_t sizeHint, bool direct, size_t bufferSize)
+    : m_bufferSize{std::max<size_t>(bufferSize, 1)} {
+  int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+#ifdef __linux__
+  if (direct) {
+    flags |= O_DIRECT;
+  }
+#endif
+  m_fd = ::open(path.c_str(), flags, 0644);
+#ifdef __linux__
+  if (m_fd < 0 && direct && errno == EINVAL) {
+    // File system without O_DIRECT support (tmpfs...).
+    direct = false;
+    m_fd = ::open(path.c_str(), flags & ~O_DIRECT, 0644);
+  }
+#endif
+  if (m_fd < 0) {
+    throwErrno("FileSink: cannot open file");
+  }
+#ifdef __linux__
+  m_direct = direct;
+  if (m_direct) {
+    m_bufferSize = (m_bufferSize + DirectAlignment - 1) & ~(DirectAlignment - 1);
+    m_aligned = static_cast<char *>(std::aligned_alloc(DirectAlignment, m_bufferSize));
+    if (!m_aligned) {
+      ::close(m_fd);
+      throw std::bad_alloc();
+    }
+  }
+  if (sizeHint) {
+    // Best effort: preallocation failures (unsupported by the file system...) are not errors.
+    (void)::fallocate(m_fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(sizeHint));
+  }
+#else
+  (void)sizeHint;
+  (void)direct;
+#endif
+}
+
+FileSink::~FileSink() {
+  try {
+    finish();
+  } catch (...) {
+  }
+  std::free(m_aligned);
+}
+
+void FileSink::write(std::string &buffer) {
+  if (m_fd < 0) {
+    throw std::runtime_error("FileSink: file is closed !");
+  }
+  if (m_direct) {
+    for (size_t pos = 0; pos < buffer.size();) {
+      const size_t n = std::min(m_bufferSize - m_alignedSize, buffer.size() - pos);
+      std::memcpy(m_aligned + m_alignedSize, buffer.data() + pos, n);
+      m_alignedSize += n;
+      pos += n;
+      if (m_alignedSize == m_bufferSize) {
+        writeDirect(m_bufferSize);
+      }
+    }
+    return;
+  }
+  if (buffer.empty()) {
+    return;
+  }
+  m_pendingBytes += buffer.size();
+  m_pending.push_back(std::move(buffer));
+  buffer = std::string();
+  if (!m_free.empty()) {
+    buffer.swap(m_free.back());
+    m_free.pop_back();
+  }
+  if (m_pendingBytes >= m_bufferSize || m_pending.size() >= MaxIov) {
+    writePending();
+  }
+}
+
+void FileSink::flush() {
+  if (m_fd < 0) {
+    return;
+  }
+  if (m_direct) {
+    const size_t aligned = m_alignedSize & ~(DirectAlignment - 1);
+    if (aligned) {
+      writeDirect(aligned);
+    }
+  } else {
+    writePending();
+  }
+}
+
+void FileSink::finish() {
+  if (m_fd < 0) {
+    return;
+  }
+  try {
+    flush();
+#ifdef __linux__
+    if (m_direct && m_alignedSize) {
+      // Unaligned tail: written without O_DIRECT.
+      int flags = ::fcntl(m_fd, F_GETFL);
+      if (flags < 0 || ::fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) < 0) {
+        throwErrno("FileSink: cannot write file");
+      }
+      const char *data = m_aligned;
+      writeAll(&data, &m_alignedSize, 1);
+      m_alignedSize = 0;
+    }
+#endif
+  } catch (...) {
+    ::close(m_fd);
+    m_fd = -1;
+    throw;
+  }
+  const int fd = m_fd;
+  m_fd = -1;
+  if (::close(fd) < 0) {
+    throwErrno("FileSink: cannot close file");
+  }
+}
+
+void FileSink::writeAll(const char *const *buffers, const size_t *sizes, size_t count) {
+  std::vector<iovec> iov(count);
+  for (size_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<char *>(buffers[i]);
+    iov[i].iov_len = sizes[i];
+  }
+  size_t first = 0;
+  while (first < count) {
+    const ssize_t n = ::pwritev(m_fd, iov.data() + first, static_cast<int>(std::min(count - first, MaxIov)),
+                                static_cast<off_t>(m_offset));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throwErrno("FileSink: cannot write file");
+    }
+    m_offset += static_cast<uint64_t>(n);
+    size_t written = static_cast<size_t>(n);
+    while (first < count && written >= iov[first].iov_len) {
+      written -= iov[first].iov_len;
+      first++;
+    }
+    if (written) {
+      iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + written;
+      iov[first].iov_len -= written;
+    }
+  }
+}
+
+void FileSink::writePending() {
+  if (m_pending.empty()) {
+    return;
+  }
+  std::vector<const char *> buffers;
+  std::vector<size_t> sizes;
+  buffers.reserve(m_pending.size());
+  sizes.reserve(m_pending.size());
+  for (auto const &buffer : m_pending) {
+    buffers.push_back(buffer.data());
+    sizes.push_back(buffer.size());
+  }
+  writeAll(buffers.data(), sizes.data(), m_pending.size());
+  for (auto &buffer : m_pending) {
+    if (m_free.size() < MaxIov) {
+      buffer.clear();
+      m_free.push_back(std::move(buffer));
+    }
+  }
+  m_pending.clear();
+  m_pendingBytes = 0;
+}
+
+void FileSink::writeDirect(size_t size) {
+  const char *data = m_aligned;
+  writeAll(&data, &size, 1);
+  std::memmove(m_aligned, m_aligned + size, m_alignedSize - size);
+  m_alignedSize -= size;
+}
+
+#endif
@@ -0,0 +1,324 @@
+#include "boost/JsonCbor.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Maximum nesting level of a decoded item.
+ */
+constexpr size_t MaxDepth = 1024;
+
+enum Major : uint8_t { UnsignedInt = 0, NegativeInt = 1, Bytes = 2, Text = 3, Array = 4, Map = 5, Tag = 6, Simple = 7 };
+
+constexpr uint8_t False = 0xF4;
+constexpr uint8_t True = 0xF5;
+constexpr uint8_t Null = 0xF6;
+constexpr uint8_t Undefined = 0xF7;
+constexpr uint8_t Half = 0xF9;
+constexpr uint8_t Single = 0xFA;
+constexpr uint8_t Double = 0xFB;
+constexpr uint8_t Break = 0xFF;
+/**
+ * @brief Additional information of the indefinite length items.
+ */
+constexpr uint8_t Indefinite = 31;
+
+void head(std::string &out, Major major, uint64_t v) {
+  const char m = static_cast<char>(major << 5);
+  if (v < 24) {
+    out += static_cast<char>(m | static_cast<char>(v));
+    return;
+  }
+  const int bytes = v <= 0xFF ? 1 : v <= 0xFFFF ? 2 : v <= 0xFFFFFFFF ? 4 : 8;
+  out += static_cast<char>(m | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27));
+  for (int b = bytes - 1; b >= 0; b--) {
+    out += static_cast<char>(v >> (8 * b));
+  }
+}
+
+void encodeString(std::string &out, boost::json::string_view str) {
+  head(out, Text, str.size());
+  out.append(str.data(), str.size());
+}
+
+void encodeValue(std::string &out, const boost::json::value &jv) {
+  switch (jv.kind()) {
+  case boost::json::kind::null:
+    out += static_cast<char>(Null);
+    break;
+  case boost::json::kind::bool_:
+    out += static_cast<char>(jv.get_bool() ? True : False);
+    break;
+  case boost::json::kind::int64: {
+    const int64_t i = jv.get_int64();
+    if (i >= 0) {
+      head(out, UnsignedInt, static_cast<uint64_t>(i));
+    } else {
+      head(out, NegativeInt, static_cast<uint64_t>(-(i + 1)));
+    }
+    break;
+  }
+  case boost::json::kind::uint64:
+    head(out, UnsignedInt, jv.get_uint64());
+    break;
+  case boost::json::kind::double_: {
+    const double d = jv.get_double();
+    const float f = static_cast<float>(d);
+    if (static_cast<double>(f) == d || std::isnan(d)) {
+      uint32_t bits;
+      std::memcpy(&bits, &f, sizeof(bits));
+      out += static_cast<char>(Single);
+      for (int b = 3; b >= 0; b--) {
+        out += static_cast<char>(bits >> (8 * b));
+      }
+    } else {
+      uint64_t bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      out += static_cast<char>(Double);
+      for (int b = 7; b >= 0; b--) {
+        out += static_cast<char>(bits >> (8 * b));
+      }
+    }
+    break;
+  }
+  case boost::json::kind::string:
+    encodeString(out, jv.get_string());
+    break;
+  case boost::json::kind::array:
+    head(out, Array, jv.get_array().size());
+    for (auto const &v : jv.get_array()) {
+      encodeValue(out, v);
+    }
+    break;
+  case boost::json::kind::object:
+    head(out, Map, jv.get_object().size());
+    for (auto const &member : jv.get_object()) {
+      encodeString(out, member.key());
+      encodeValue(out, member.value());
+    }
+    break;
+  }
+}
+
+class Decoder {
+public:
+  explicit Decoder(std::string_view data) : m_data{data} {}
+
+  bool done() const { return m_pos == m_data.size(); }
+
+  void value(boost::json::value &jv, size_t depth) {
+    if (depth > MaxDepth) {
+      fail();
+    }
+    uint8_t initial = byte();
+    while ((initial >> 5) == Tag) {
+      argument(initial & 31);
+      initial = byte();
+    }
+    const uint8_t info = initial & 31;
+    switch (initial >> 5) {
+    case UnsignedInt: {
+      const uint64_t u = argument(info);
+      if (u <= uint64_t(INT64_MAX)) {
+        jv = static_cast<int64_t>(u);
+      } else {
+        jv = u;
+      }
+      break;
+    }
+    case NegativeInt: {
+      const uint64_t n = argument(info);
+      if (n > uint64_t(INT64_MAX)) {
+        fail();
+      }
+      jv = -1 - static_cast<int64_t>(n);
+      break;
+    }
+    case Text:
+      string(info, jv.emplace_string());
+      break;
+    case Array: {
+      boost::json::array &arr = jv.emplace_array();
+      if (info == Indefinite) {
+        while (!atBreak()) {
+          value(arr.emplace_back(nullptr), depth + 1);
+        }
+      } else {
+        const uint64_t count = length(info, 1);
+        arr.resize(count);
+        for (uint64_t i = 0; i < count; i++) {
+          value(arr[i], depth + 1);
+        }
+      }
+      break;
+    }
+    case Map: {
+      boost::json::object &obj = jv.emplace_object();
+      const bool indefinite = (info == Indefinite);
+      const uint64_t count = indefinite ? 0 : length(info, 2);
+      obj.reserve(count);
+      for (uint64_t i = 0; indefinite ? !atBreak() : i < count; i++) {
+        boost::json::string key;
+        const uint8_t k = byte();
+        if ((k >> 5) != Text) {
+          fail();
+        }
+        string(k & 31, key);
+        value(obj[key], depth + 1);
+      }
+      break;
+    }
+    case Simple:
+      simple(initial, jv);
+      break;
+    default:
+      fail();
+    }
+  }
+
+private:
+  [[noreturn]] static void fail() { throw std::runtime_error("Invalid CBOR data !"); }
+
+  uint8_t byte() {
+    if (m_pos == m_data.size()) {
+      fail();
+    }
+    return static_cast<uint8_t>(m_data[m_pos++]);
+  }
+  uint64_t bigEndian(size_t bytes) {
+    if (bytes > m_data.size() - m_pos) {
+      fail();
+    }
+    uint64_t v = 0;
+    for (size_t b = 0; b < bytes; b++) {
+      v = (v << 8) | static_cast<uint8_t>(m_data[m_pos++]);
+    }
+    return v;
+  }
+  uint64_t argument(uint8_t info) {
+    if (info < 24) {
+      return info;
+    }
+    if (info > 27) {
+      fail();
+    }
+    return bigEndian(size_t(1) << (info - 24));
+  }
+  /**
+   * @brief Definite length of an item, checked against the remaining data (each element taking at least minSize bytes).
+   */
+  uint64_t length(uint8_t info, uint64_t minSize) {
+    const uint64_t n = argument(info);
+    if (n > (m_data.size() - m_pos) / minSize) {
+      fail();
+    }
+    return n;
+  }
+  bool atBreak() {
+    if (m_pos == m_data.size()) {
+      fail();
+    }
+    if (static_cast<uint8_t>(m_data[m_pos]) == Break) {
+      m_pos++;
+      return true;
+    }
+    return false;
+  }
+  void string(uint8_t info, boost::json::string &str) {
+    if (info == Indefinite) {
+      while (!atBreak()) {
+        const uint8_t chunk = byte();
+        if ((chunk >> 5) != Text || (chunk & 31) == Indefinite) {
+          fail();
+        }
+        string(chunk & 31, str);
+      }
+      return;
+    }
+    const uint64_t size = length(info, 1);
+    str.append(boost::json::string_view(m_data.data() + m_pos, size));
+    m_pos += size;
+  }
+  void simple(uint8_t initial, boost::json::value &jv) {
+    switch (initial) {
+    case False:
+      jv = false;
+      break;
+    case True:
+      jv = true;
+      break;
+    case Null:
+    case Undefined:
+      jv = nullptr;
+      break;
+    case Half: {
+      const uint16_t h = static_cast<uint16_t>(bigEndian(2));
+      const int exponent = (h >> 10) & 0x1F;
+      const double mantissa = h & 0x3FF;
+      double d;
+      if (exponent == 0) {
+        d = std::ldexp(mantissa, -24);
+      } else if (exponent == 31) {
+        d = mantissa == 0 ? INFINITY : NAN;
+      } else {
+        d = std::ldexp(mantissa + 1024, exponent - 25);
+      }
+      jv = (h & 0x8000) ? -d : d;
+      break;
+    }
+    case Single: {
+      const uint32_t bits = static_cast<uint32_t>(bigEndian(4));
+      float f;
+      std::memcpy(&f, &bits, sizeof(f));
+      jv = static_cast<double>(f);
+      break;
+    }
+    case Double: {
+      const uint64_t bits = bigEndian(8);
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      jv = d;
+      break;
+    }
+    default:
+      fail();
+    }
+  }
+
+  std::string_view m_data;
+  size_t m_pos = 0;
+};
+} // namespace
+
+std::string JsonCbor::encode(const boost::json::value &jv) {
+  std::string out;
+  encodeValue(out, jv);
+  return out;
+}
+
+void JsonCbor::write(const boost::json::value &jv, JsonSink &sink) {
+  std::string out = encode(jv);
+  sink.write(out);
+}
+
+boost::json::value JsonCbor::decode(std::string_view data) {
+  Decoder decoder(data);
+  boost::json::value jv;
+  decoder.value(jv, 0);
+  if (!decoder.done()) {
+    throw std::runtime_error("Invalid CBOR data !");
+  }
+  return jv;
+}
+
+boost::json::value JsonCbor::read(JsonSource &source) {
+  std::string data;
+  std::string block(JsonSource::BlockSize, '\0');
+  while (size_t n = source.read(&block[0], block.size())) {
+    data.append(block, 0, n);
+  }
+  return decode(data);
+}
@@ -1,5 +1,10 @@
 #include "boost/JsonContext.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
 #ifdef __GNUG__
 #include <cstdlib>
 #include <cxxabi.h>
@@ -25,6 +30,400 @@ std::string demangle(const char *name) {
 std::string demangle(const char *name) { return name; }
 #endif
 
+boost::json::value JsonContext::parse(JsonSource &source, boost::system::error_code &ec, boost::json::storage_ptr sp,
+                                      boost::json::parse_options const &opt) {
+  boost::json::stream_parser parser(sp, opt);
+  std::string block(JsonSource::BlockSize, '\0');
+  // Enough bytes to recognize a snapshot header.
+  size_t n = 0;
+  while (n < JsonSnapshot::HeaderSize) {
+    const size_t read = source.read(&block[n], block.size() - n);
+    if (read == 0) {
+      break;
+    }
+    n += read;
+  }
+  if (JsonSnapshot::isSnapshot(std::string_view(block.data(), n))) {
+    std::string snapshot(block, 0, n);
+    while ((n = source.read(&block[0], block.size()))) {
+      snapshot.append(block, 0, n);
+    }
+    return decodeSnapshot(snapshot, ec, std::move(sp));
+  }
+  for (; n; n = source.read(&block[0], block.size())) {
+    parser.write(block.data(), n, ec);
+    if (ec) {
+      return {};
+    }
+  }
+  parser.finish(ec);
+  if (ec) {
+    return {};
+  }
+  return parser.release();
+}
+
+boost::json::value JsonContext::decodeSnapshot(std::string_view data, boost::system::error_code &ec,
+                                               boost::json::storage_ptr sp) {
+  try {
+    return JsonSnapshot::decode(data, std::move(sp));
+  } catch (std::runtime_error const &) {
+    ec = boost::system::errc::make_error_code(boost::system::errc::bad_message);
+    return {};
+  }
+}
+
+namespace {
+/**
+ * @brief Walks a Json text along a Json pointer, skipping the other values byte by byte, and captures the text of the
+ * pointed value (and of the root strings table). Only the member keys read along the way are validated: skipped
+ * values are not, the captured texts are validated when parsed.
+ */
+class PointerScanner {
+public:
+  PointerScanner(JsonSource &source, const std::vector<std::string> &tokens)
+      : m_source{source}, m_tokens{tokens}, m_block(JsonSource::BlockSize, '\0') {}
+
+  /**
+   * @brief Scan the whole document.
+   * @param value Text of the pointed value.
+   * @param table Text of the root strings table.
+   * @return true if the pointed value was found
+   */
+  bool scan(std::string &value, std::string &table) {
+    m_value = &value;
+    m_table = &table;
+    return find(0);
+  }
+
+private:
+  [[noreturn]] static void fail() { throw std::runtime_error("Input stream is not Json Friendly..."); }
+
+  bool fill() {
+    if (m_capture) {
+      m_capture->append(m_block, m_captureFrom, m_size - m_captureFrom);
+      m_captureFrom = 0;
+    }
+    if (m_end) {
+      return false;
+    }
+    m_size = m_source.read(&m_block[0], m_block.size());
+    m_pos = 0;
+    m_end = (m_size == 0);
+    return m_size != 0;
+  }
+  int peek() {
+    if (m_pos == m_size && !fill()) {
+      return -1;
+    }
+    return static_cast<unsigned char>(m_block[m_pos]);
+  }
+  char get() {
+    int c = peek();
+    if (c < 0) {
+      fail();
+    }
+    m_pos++;
+    return static_cast<char>(c);
+  }
+  void expect(char expected) {
+    skipSpaces();
+    if (get() != expected) {
+      fail();
+    }
+  }
+  void skipSpaces() {
+    for (int c = peek(); c == ' ' || c == '\t' || c == '\n' || c == '\r'; c = peek()) {
+      m_pos++;
+    }
+  }
+
+  /**
+   * @brief Skip the rest of a string (opening quote already read).
+   */
+  void skipString() {
+    for (;;) {
+      if (m_pos == m_size && !fill()) {
+        fail();
+      }
+      const char *p = m_block.data() + m_pos;
+      const char *end = m_block.data() + m_size;
+      while (p != end && *p != '"' && *p != '\\') {
+        p++;
+      }
+      m_pos = static_cast<size_t>(p - m_block.data());
+      if (p == end) {
+        continue;
+      }
+      m_pos++;
+      if (*p == '"') {
+        return;
+      }
+      get();
+    }
+  }
+
+  /**
+   * @brief Skip one value.
+   */
+  void skip() {
+    skipSpaces();
+    char c = get();
+    if (c == '"') {
+      skipString();
+    } else if (c == '{' || c == '[') {
+      for (size_t depth = 1; depth;) {
+        c = get();
+        if (c == '"') {
+          skipString();
+        } else if (c == '{' || c == '[') {
+          depth++;
+        } else if (c == '}' || c == ']') {
+          depth--;
+        }
+      }
+    } else {
+      for (int n = peek(); n >= 0 && n != ',' && n != '}' && n != ']' && n != ' ' && n != '\t' && n != '\n' && n != '\r';
+           n = peek()) {
+        m_pos++;
+      }
+    }
+  }
+
+  /**
+   * @brief Skip one value, appending its text to out.
+   * @param out
+   */
+  void capture(std::string &out) {
+    skipSpaces();
+    m_capture = &out;
+    m_captureFrom = m_pos;
+    skip();
+    out.append(m_block, m_captureFrom, m_pos - m_captureFrom);
+    m_capture = nullptr;
+  }
+
+  static unsigned hex(char c) {
+    if (c >= '0' && c <= '9') {
+      return static_cast<unsigned>(c - '0');
+    }
+    if (c >= 'a' && c <= 'f') {
+      return static_cast<unsigned>(c - 'a' + 10);
+    }
+    if (c >= 'A' && c <= 'F') {
+      return static_cast<unsigned>(c - 'A' + 10);
+    }
+    fail();
+  }
+  unsigned codeUnit() {
+    unsigned u = 0;
+    for (int i = 0; i < 4; i++) {
+      u = (u << 4) | hex(get());
+    }
+    return u;
+  }
+
+  /**
+   * @brief Read the rest of a member key (opening quote already read), unescaped.
+   * @return std::string
+   */
+  std::string key() {
+    std::string key;
+    for (char c = get(); c != '"'; c = get()) {
+      if (c != '\\') {
+        key += c;
+        continue;
+      }
+      switch (c = get()) {
+      case 'b':
+        key += '\b';
+        break;
+      case 'f':
+        key += '\f';
+        break;
+      case 'n':
+        key += '\n';
+        break;
+      case 'r':
+        key += '\r';
+        break;
+      case 't':
+        key += '\t';
+        break;
+      case 'u': {
+        unsigned cp = codeUnit();
+        if (cp >= 0xDC00 && cp < 0xE000) {
+          // Low surrogate without high surrogate.
+          fail();
+        }
+        if (cp >= 0xD800 && cp < 0xDC00) {
+          if (get() != '\\' || get() != 'u') {
+            fail();
+          }
+          const unsigned low = codeUnit();
+          if (low < 0xDC00 || low >= 0xE000) {
+            fail();
+          }
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (cp < 0x80) {
+          key += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+          key += static_cast<char>(0xC0 | (cp >> 6));
+          key += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+          key += static_cast<char>(0xE0 | (cp >> 12));
+          key += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          key += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+          key += static_cast<char>(0xF0 | (cp >> 18));
+          key += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+          key += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+          key += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+        break;
+      }
+      case '"':
+      case '\\':
+      case '/':
+        key += c;
+        break;
+      default:
+        fail();
+      }
+    }
+    return key;
+  }
+
+  /**
+   * @brief Array index of a pointer token.
+   * @param token
+   * @return size_t (SIZE_MAX when the token is not an index)
+   */
+  static size_t index(const std::string &token) {
+    if (token.empty() || (token.size() > 1 && token[0] == '0') || token.size() > 18) {
+      return SIZE_MAX;
+    }
+    size_t i = 0;
+    for (char c : token) {
+      if (c < '0' || c > '9') {
+        return SIZE_MAX;
+      }
+      i = i * 10 + static_cast<size_t>(c - '0');
+    }
+    return i;
+  }
+
+  /**
+   * @brief Scan one value, located by the first level pointer tokens.
+   * @param level
+   * @return true if the pointed value was found in it
+   */
+  bool find(size_t level) {
+    if (level == m_tokens.size()) {
+      capture(*m_value);
+      return true;
+    }
+    skipSpaces();
+    const int c = peek();
+    if (c != '{' && c != '[') {
+      skip();
+      return false;
+    }
+    m_pos++;
+    skipSpaces();
+    if (peek() == (c == '{' ? '}' : ']')) {
+      m_pos++;
+      return false;
+    }
+    bool found = false;
+    const size_t wanted = (c == '[') ? index(m_tokens[level]) : 0;
+    for (size_t i = 0;; i++) {
+      if (c == '{') {
+        expect('"');
+        std::string name = key();
+        expect(':');
+        if (!found && name == m_tokens[level]) {
+          found = find(level + 1);
+        } else if (level == 0 && name == param::StringTableType) {
+          m_table->clear();
+          capture(*m_table);
+        } else {
+          skip();
+        }
+      } else if (!found && i == wanted) {
+        found = find(level + 1);
+      } else {
+        skip();
+      }
+      skipSpaces();
+      const char next = get();
+      if (next == (c == '{' ? '}' : ']')) {
+        return found;
+      }
+      if (next != ',') {
+        fail();
+      }
+    }
+  }
+
+  JsonSource &m_source;
+  const std::vector<std::string> &m_tokens;
+  std::string m_block;
+  size_t m_pos = 0;
+  size_t m_size = 0;
+  bool m_end = false;
+  /**
+   * @brief Text being captured (from m_captureFrom in the current block).
+   */
+  std::string *m_capture = nullptr;
+  size_t m_captureFrom = 0;
+  std::string *m_value = nullptr;
+  std::string *m_table = nullptr;
+};
+} // namespace
+
+bool JsonContext::project(JsonSource &source, const std::string &pointer, boost::json::value &projection) {
+  if (pointer.empty() || pointer[0] != '/') {
+    throw std::runtime_error("Invalid Json pointer !");
+  }
+  std::vector<std::string> tokens;
+  for (size_t pos = 1;;) {
+    const size_t end = std::min(pointer.find('/', pos), pointer.size());
+    std::string token;
+    for (size_t i = pos; i < end; i++) {
+      if (pointer[i] != '~') {
+        token += pointer[i];
+      } else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+        token += (pointer[++i] == '0') ? '~' : '/';
+      } else {
+        throw std::runtime_error("Invalid Json pointer !");
+      }
+    }
+    tokens.push_back(std::move(token));
+    if (end == pointer.size()) {
+      break;
+    }
+    pos = end + 1;
+  }
+
+  std::string value;
+  std::string table;
+  if (!PointerScanner(source, tokens).scan(value, table)) {
+    return false;
+  }
+  boost::system::error_code ec;
+  boost::json::object &o = projection.emplace_object();
+  o[tokens.back()] = boost::json::parse(value, ec);
+  if (!ec && !table.empty()) {
+    o[param::StringTableType] = boost::json::parse(table, ec);
+  }
+  if (ec) {
+    throw std::runtime_error("Input stream is not Json Friendly...");
+  }
+  return true;
+}
+
 JsonContext::JsonContext(std::shared_ptr<boost::json::value> root) : m_context(), m_root{root}, m_current({"root", m_root}) {}
 
 JsonContext::JsonContext() : m_context(), m_root(std::make_shared<boost::json::value>()), m_current({"root", m_root}) {}
@@ -68,88 +467,289 @@ void JsonContext::setCurrentTag(std::string tag) { m_current_tag = tag; }
 
 std::string JsonContext::currentTag() { return m_current_tag; }
 
-void pretty_print(std::ostream &os, boost::json::value const &jv, std::string *indent = nullptr) {
-  std::string indent_;
-  if (!indent)
-    indent = &indent_;
-  switch (jv.kind()) {
-  case boost::json::kind::object: {
-    os << "{\n";
-    indent->append(4, ' ');
-    auto const &obj = jv.get_object();
-    if (!obj.empty()) {
-      auto it = obj.begin();
-      for (;;) {
-        os << *indent << boost::json::serialize(it->key()) << " : ";
-        pretty_print(os, it->value(), indent);
-        if (++it == obj.end())
-          break;
-        os << ",\n";
+uint64_t JsonContext::intern(const std::string &str) {
+  auto it = m_string_index.emplace(str, m_string_table.size());
+  if (it.second) {
+    m_string_table.emplace_back(str);
+  }
+  return it.first->second;
+}
+
+void JsonContext::setStringTable(const boost::json::array *table) { m_string_refs = table; }
+
+const boost::json::value &JsonContext::resolve(const boost::json::value &value) const {
+  if (m_string_refs && (value.is_int64() || value.is_uint64())) {
+    return m_string_refs->at(value.to_number<size_t>());
+  }
+  return value;
+}
+
+const boost::json::value &JsonContext::document() {
+  if (!m_string_table.empty() && m_root->is_object()) {
+    m_root->get_object()[param::StringTableType] = std::move(m_string_table);
+    m_string_table = boost::json::array();
+    m_string_index.clear();
+  }
+  return *m_root;
+}
+
+boost::json::value JsonContext::takeDocument() {
+  document();
+  return std::exchange(*m_root, boost::json::value());
+}
+
+void JsonContext::serialize(std::ostream &os, bool prettify) {
+  JsonWriter writer(os, prettify);
+  writer.write(document());
+  writer.flush();
+}
+
+bool JsonContext::toColumns(const boost::json::array &rows, boost::json::value &columnar) {
+  boost::json::object index;
+  boost::json::array columns;
+  for (auto const &row : rows) {
+    if (!row.is_object()) {
+      return false;
+    }
+    for (auto const &member : row.get_object()) {
+      if (index.emplace(member.key(), columns.size()).second) {
+        columns.emplace_back(member.key());
       }
     }
-    os << "\n";
-    indent->resize(indent->size() - 4);
-    os << *indent << "}";
-    break;
   }
+  boost::json::array values(columns.size(), boost::json::array());
+  for (auto &column : values) {
+    column.get_array().reserve(rows.size());
+  }
+  for (auto const &row : rows) {
+    auto const &obj = row.get_object();
+    for (size_t i = 0; i < columns.size(); i++) {
+      auto const *member = obj.if_contains(columns[i].get_string());
+      values[i].get_array().push_back(member ? *member : boost::json::value());
+    }
+  }
+  if (columns.empty()) {
+    // Rows without members: the row count would be lost.
+    return false;
+  }
+  boost::json::object &o = columnar.emplace_object();
+  o[param::ColumnsType] = std::move(columns);
+  o[param::ColumnValuesType] = std::move(values);
+  return true;
+}
+
+bool JsonContext::isColumnar(const boost::json::value &value) {
+  auto const *obj = value.if_object();
+  if (!obj || obj->size() != 2) {
+    return false;
+  }
+  auto const *columns = obj->if_contains(param::ColumnsType);
+  auto const *values = obj->if_contains(param::ColumnValuesType);
+  return columns && values && columns->is_array() && values->is_array() &&
+         columns->get_array().size() == values->get_array().size();
+}
+
+size_t JsonContext::columnsRows(const boost::json::value &columnar) {
+  auto const &keys = columnsKeys(columnar);
+  auto const &values = columnsValues(columnar);
+  const size_t rows = !values.empty() && values[0].is_array() ? values[0].get_array().size() : 0;
+  for (size_t i = 0; i < keys.size(); i++) {
+    if (!keys[i].is_string() || !values[i].is_array() || values[i].get_array().size() != rows) {
+      throw std::runtime_error("Malformed Json columns !");
+    }
+  }
+  return rows;
+}
+
+const boost::json::array &JsonContext::columnsKeys(const boost::json::value &columnar) {
+  return columnar.get_object().at(param::ColumnsType).get_array();
+}
+
+const boost::json::array &JsonContext::columnsValues(const boost::json::value &columnar) {
+  return columnar.get_object().at(param::ColumnValuesType).get_array();
+}
+
+const boost::json::value *JsonContext::columnsMember(const boost::json::array &keys, const boost::json::array &values,
+                                                     size_t row, boost::json::string_view key, size_t &cursor) {
+  const size_t count = keys.size();
+  size_t column = cursor < count ? cursor : 0;
+  for (size_t n = 0; n < count; n++) {
+    if (keys[column].get_string() == key) {
+      cursor = column + 1;
+      const boost::json::value &value = values[column].get_array()[row];
+      return value.is_null() ? nullptr : &value;
+    }
+    column = column + 1 < count ? column + 1 : 0;
+  }
+  return nullptr;
+}
+
+namespace {
+constexpr char Base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct Base64Table {
+  uint8_t values[256];
+  constexpr Base64Table() : values() {
+    for (auto &v : values) {
+      v = 0xFF;
+    }
+    for (uint8_t i = 0; i < 64; i++) {
+      values[static_cast<uint8_t>(Base64Chars[i])] = i;
+    }
+  }
+};
+constexpr Base64Table Base64Values;
+} // namespace
+
+std::string JsonContext::base64Encode(const std::vector<uint8_t> &bytes) {
+  std::string out((bytes.size() + 2) / 3 * 4, '=');
+  size_t o = 0;
+  size_t i = 0;
+  for (; i + 3 <= bytes.size(); i += 3) {
+    uint32_t n = (uint32_t(bytes[i]) << 16) | (uint32_t(bytes[i + 1]) << 8) | bytes[i + 2];
+    out[o++] = Base64Chars[(n >> 18) & 63];
+    out[o++] = Base64Chars[(n >> 12) & 63];
+    out[o++] = Base64Chars[(n >> 6) & 63];
+    out[o++] = Base64Chars[n & 63];
+  }
+  if (i < bytes.size()) {
+    uint32_t n = uint32_t(bytes[i]) << 16;
+    if (i + 1 < bytes.size()) {
+      n |= uint32_t(bytes[i + 1]) << 8;
+    }
+    out[o++] = Base64Chars[(n >> 18) & 63];
+    out[o++] = Base64Chars[(n >> 12) & 63];
+    if (i + 1 < bytes.size()) {
+      out[o++] = Base64Chars[(n >> 6) & 63];
+    }
+  }
+  return out;
+}
 
-  case boost::json::kind::array: {
-    os << "[\n";
-    indent->append(4, ' ');
-    auto const &arr = jv.get_array();
-    if (!arr.empty()) {
-      auto it = arr.begin();
-      for (;;) {
-        os << *indent;
-        pretty_print(os, *it, indent);
-        if (++it == arr.end())
-          break;
-        os << ",\n";
+std::vector<uint8_t> JsonContext::base64Decode(boost::json::string_view str) {
+  std::vector<uint8_t> out;
+  out.reserve(str.size() / 4 * 3);
+  uint32_t n = 0;
+  int bits = 0;
+  for (char c : str) {
+    uint8_t v = Base64Values.values[static_cast<uint8_t>(c)];
+    if (v == 0xFF) {
+      if (c == '=') {
+        break;
       }
+      throw std::runtime_error("Invalid base64 bitstring !");
+    }
+    n = (n << 6) | v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<uint8_t>(n >> bits));
     }
-    os << "\n";
-    indent->resize(indent->size() - 4);
-    os << *indent << "]";
-    break;
   }
+  return out;
+}
+
+bool JsonContext::isPackedBits(const boost::json::value &value) {
+  auto const *obj = value.if_object();
+  if (!obj || obj->size() != 2) {
+    return false;
+  }
+  auto const *bits = obj->if_contains(param::BitsType);
+  auto const *size = obj->if_contains(param::BitsSizeType);
+  return bits && size && bits->is_string() && size->is_number();
+}
+
+size_t JsonContext::packedBitsSize(const boost::json::value &packed) {
+  return packed.get_object().at(param::BitsSizeType).to_number<size_t>();
+}
 
-  case boost::json::kind::string: {
-    os << boost::json::serialize(jv.get_string());
-    break;
+std::vector<uint8_t> JsonContext::packedBytes(const boost::json::value &packed, size_t count) {
+  if (count > packedBitsSize(packed)) {
+    throw std::runtime_error("Truncated bitstring !");
   }
+  std::vector<uint8_t> bytes = base64Decode(packed.get_object().at(param::BitsType).get_string());
+  if (bytes.size() * 8 < count) {
+    throw std::runtime_error("Truncated bitstring !");
+  }
+  return bytes;
+}
 
-  case boost::json::kind::uint64:
-    os << jv.get_uint64();
-    break;
+namespace {
+bool hasClassId(const boost::json::object &obj) {
+  return obj.contains(param::ClassIdType) || obj.contains(param::ClassIdOptionalType) ||
+         obj.contains(param::ClassIdReferenceType) || obj.contains(param::ClassNameType);
+}
 
-  case boost::json::kind::int64:
-    os << jv.get_int64();
-    break;
+bool hasObjectId(const boost::json::object &obj) {
+  return obj.contains(param::ObjectIdType) || obj.contains(param::ObjectReferenceType);
+}
 
-  case boost::json::kind::double_:
-    os << jv.get_double();
-    break;
+bool isClassIdKey(boost::json::string_view key) {
+  const std::string_view k(key.data(), key.size());
+  return k == param::ClassIdKey.name() || k == param::ClassIdOptionalKey.name() ||
+         k == param::ClassIdReferenceKey.name() || k == param::ClassNameKey.name();
+}
 
-  case boost::json::kind::bool_:
-    if (jv.get_bool())
-      os << "true";
-    else
-      os << "false";
-    break;
+bool isObjectIdKey(boost::json::string_view key) {
+  const std::string_view k(key.data(), key.size());
+  return k == param::ObjectIdKey.name() || k == param::ObjectReferenceKey.name();
+}
 
-  case boost::json::kind::null:
-    os << "null";
-    break;
+template <typename Match> bool anyObject(const boost::json::value &value, const Match &match) {
+  if (auto const *arr = value.if_array()) {
+    for (auto const &v : *arr) {
+      if (anyObject(v, match)) {
+        return true;
+      }
+    }
+  } else if (auto const *obj = value.if_object()) {
+    if (match(*obj)) {
+      return true;
+    }
+    for (auto const &member : *obj) {
+      if (anyObject(member.value(), match)) {
+        return true;
+      }
+    }
   }
+  return false;
+}
+} // namespace
 
-  if (indent->empty())
-    os << "\n";
+bool JsonContext::hasMetadata(const boost::json::value &value) {
+  return anyObject(value, [](const boost::json::object &obj) { return hasClassId(obj) || hasObjectId(obj); });
 }
 
-void JsonContext::serialize(std::ostream &os, bool prettify) {
-  if (prettify) {
-    pretty_print(os, *m_root);
-  } else {
-    os << *m_root;
+bool JsonContext::hasMetadata(const boost::json::array &keys, const boost::json::array &values, size_t row) {
+  for (size_t i = 0; i < keys.size(); i++) {
+    const boost::json::value &value = values[i].get_array()[row];
+    if (value.is_null()) {
+      continue;
+    }
+    const boost::json::string &key = keys[i].get_string();
+    if (isClassIdKey(key) || isObjectIdKey(key) || hasMetadata(value)) {
+      return true;
+    }
   }
-}
\ No newline at end of file
+  return false;
+}
+
+bool JsonContext::hasTracking(const boost::json::value &value) {
+  return anyObject(value, [](const boost::json::object &obj) {
+    if (hasObjectId(obj) || obj.contains(param::ClassIdReferenceType) ||
+        obj.contains(param::ClassNameType)) {
+      return true;
+    }
+    auto const *tracking = obj.if_contains(param::TrackingType);
+    return tracking && tracking->is_bool() && tracking->get_bool() && hasClassId(obj);
+  });
+}
+
+bool JsonContext::hasClassInfo(const boost::json::value &value) { return anyObject(value, hasClassId); }
+
+bool JsonContext::hasReferences(const boost::json::value &value) {
+  return anyObject(value, [](const boost::json::object &obj) {
+    return obj.contains(param::ObjectReferenceType) || obj.contains(param::ClassIdType) ||
+           obj.contains(param::ClassIdReferenceType) || obj.contains(param::ClassNameType);
+  });
+}
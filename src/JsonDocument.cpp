@@ -0,0 +1,37 @@
+#include "boost/JsonDocument.hpp"
+
+#include <stdexcept>
+
+#include "boost/JsonContext.hpp"
+
+std::shared_ptr<const JsonDocument> JsonDocument::parse(std::istream &is) {
+  boost::system::error_code ec;
+  boost::json::value root = JsonContext::parse(is, ec);
+  if (ec) {
+    throw std::runtime_error("Input stream is not Json Friendly...");
+  }
+  return std::make_shared<const JsonDocument>(std::move(root));
+}
+
+std::shared_ptr<const JsonDocument> JsonDocument::parse(JsonSource &source) {
+  boost::system::error_code ec;
+  boost::json::value root = JsonContext::parse(source, ec);
+  if (ec) {
+    throw std::runtime_error("Input stream is not Json Friendly...");
+  }
+  return std::make_shared<const JsonDocument>(std::move(root));
+}
+
+JsonDocument::JsonDocument(boost::json::value &&root) : m_root(std::move(root)) {
+  if (auto const *obj = m_root.if_object()) {
+    if (auto const *table = obj->if_contains(param::StringTableType); table && table->is_array()) {
+      m_string_table = &table->get_array();
+    }
+  }
+}
+
+const boost::json::value *JsonDocument::find(const std::string &pointer) const {
+  boost::system::error_code ec;
+  const boost::json::value *value = m_root.find_pointer(pointer, ec);
+  return ec ? nullptr : value;
+}
@@ -0,0 +1,139 @@
+#include "boost/JsonDocumentCache.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+JsonDocumentCache::JsonDocumentCache(size_t budget) : m_budget{budget} {}
+
+JsonDocumentCache &JsonDocumentCache::instance() {
+  static JsonDocumentCache cache;
+  return cache;
+}
+
+std::shared_ptr<const JsonDocument> JsonDocumentCache::load(const std::string &path) {
+  std::error_code ec;
+  const uint64_t fileSize = std::filesystem::file_size(path, ec);
+  const std::filesystem::file_time_type mtime = ec ? std::filesystem::file_time_type() : std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    throw std::runtime_error("JsonDocumentCache: cannot read " + path + ": " + ec.message());
+  }
+  std::promise<std::shared_ptr<const JsonDocument>> promise;
+  uint64_t ticket;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (auto document = find(path, fileSize, mtime)) {
+      return document;
+    }
+    auto loading = m_loading.find(path);
+    if (loading != m_loading.end() && loading->second.fileSize == fileSize && loading->second.mtime == mtime) {
+      // Same file being parsed by another thread: parsed once, shared.
+      std::shared_future<std::shared_ptr<const JsonDocument>> document = loading->second.document;
+      lock.unlock();
+      return document.get();
+    }
+    ticket = ++m_tickets;
+    m_loading[path] = Loading{fileSize, mtime, ticket, promise.get_future().share()};
+  }
+
+  // Parsed without the lock held: other files can be loaded meanwhile.
+  std::shared_ptr<const JsonDocument> document;
+  try {
+    std::ifstream is{path, std::ios::binary};
+    if (!is) {
+      throw std::runtime_error("JsonDocumentCache: cannot read " + path);
+    }
+    document = JsonDocument::parse(is);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    loaded(path, ticket);
+    promise.set_exception(std::current_exception());
+    throw;
+  }
+  const size_t size = footprint(document->root());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  loaded(path, ticket);
+  if (auto cached = find(path, fileSize, mtime, true)) {
+    // Cached by another thread meanwhile (same or newer file).
+    promise.set_value(cached);
+    return cached;
+  }
+  if (size <= m_budget) {
+    m_entries.push_front(Entry{path, fileSize, mtime, size, document});
+    m_index[path] = m_entries.begin();
+    m_size += size;
+    evict();
+  }
+  promise.set_value(document);
+  return document;
+}
+
+std::shared_ptr<const JsonDocument> JsonDocumentCache::find(const std::string &path, uint64_t fileSize,
+                                                             std::filesystem::file_time_type mtime, bool keepNewer) {
+  auto it = m_index.find(path);
+  if (it == m_index.end()) {
+    return nullptr;
+  }
+  if ((it->second->fileSize == fileSize && it->second->mtime == mtime) || (keepNewer && it->second->mtime > mtime)) {
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->document;
+  }
+  m_size -= it->second->footprint;
+  m_entries.erase(it->second);
+  m_index.erase(it);
+  return nullptr;
+}
+
+void JsonDocumentCache::loaded(const std::string &path, uint64_t ticket) {
+  auto it = m_loading.find(path);
+  if (it != m_loading.end() && it->second.ticket == ticket) {
+    m_loading.erase(it);
+  }
+}
+
+void JsonDocumentCache::setBudget(size_t budget) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budget = budget;
+  evict();
+}
+
+void JsonDocumentCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_size = 0;
+}
+
+size_t JsonDocumentCache::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+size_t JsonDocumentCache::count() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+void JsonDocumentCache::evict() {
+  while (m_size > m_budget && !m_entries.empty()) {
+    m_size -= m_entries.back().footprint;
+    m_index.erase(m_entries.back().path);
+    m_entries.pop_back();
+  }
+}
+
+size_t JsonDocumentCache::footprint(const boost::json::value &jv) {
+  size_t size = sizeof(boost::json::value);
+  if (auto const *arr = jv.if_array()) {
+    for (auto const &v : *arr) {
+      size += footprint(v);
+    }
+  } else if (auto const *obj = jv.if_object()) {
+    for (auto const &member : *obj) {
+      size += member.key().size() + footprint(member.value());
+    }
+  } else if (jv.is_string()) {
+    size += jv.get_string().size();
+  }
+  return size;
+}
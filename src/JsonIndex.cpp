@@ -0,0 +1,178 @@
+#include "boost/JsonIndex.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "boost/JsonContext.hpp"
+#include "boost/JsonWriter.hpp"
+
+namespace {
+constexpr const char *StrideKey = "stride";
+constexpr const char *MembersKey = "members";
+constexpr const char *OffsetKey = "offset";
+constexpr const char *EndKey = "end";
+constexpr const char *SizeKey = "size";
+constexpr const char *ElementsKey = "elements";
+constexpr const char *ClassElementsKey = "class_elements";
+
+std::string_view slice(std::string_view text, uint64_t offset, uint64_t end) {
+  if (offset > end || end > text.size()) {
+    throw std::runtime_error("Json index does not match the document !");
+  }
+  return text.substr(offset, end - offset);
+}
+} // namespace
+
+JsonIndex::JsonIndex(size_t stride) : m_stride{std::max<size_t>(stride, 1)} {}
+
+JsonIndex JsonIndex::load(std::istream &is) {
+  boost::system::error_code ec;
+  boost::json::value jv = JsonContext::parse(is, ec);
+  if (ec || !jv.is_object()) {
+    throw std::runtime_error("Input stream is not a Json index...");
+  }
+  try {
+    auto const &obj = jv.get_object();
+    JsonIndex index(obj.at(StrideKey).to_number<size_t>());
+    for (auto const &member : obj.at(MembersKey).as_object()) {
+      auto const &e = member.value().as_object();
+      Entry &entry = index.add(std::string(member.key()));
+      entry.offset = e.at(OffsetKey).to_number<uint64_t>();
+      entry.end = e.at(EndKey).to_number<uint64_t>();
+      if (auto const *elements = e.if_contains(ElementsKey)) {
+        entry.size = e.at(SizeKey).to_number<size_t>();
+        entry.elements.reserve(elements->as_array().size());
+        for (auto const &offset : elements->as_array()) {
+          entry.elements.push_back(offset.to_number<uint64_t>());
+        }
+      }
+      if (auto const *classElements = e.if_contains(ClassElementsKey)) {
+        for (auto const &i : classElements->as_array()) {
+          entry.classElements.push_back(i.to_number<size_t>());
+        }
+      }
+    }
+    return index;
+  } catch (std::exception const &) {
+    throw std::runtime_error("Input stream is not a Json index...");
+  }
+}
+
+void JsonIndex::save(std::ostream &os) const {
+  boost::json::value jv;
+  boost::json::object &obj = jv.emplace_object();
+  obj[StrideKey] = m_stride;
+  boost::json::object &members = obj[MembersKey].emplace_object();
+  for (auto const &[name, entry] : m_entries) {
+    boost::json::object &e = members[name].emplace_object();
+    e[OffsetKey] = entry.offset;
+    e[EndKey] = entry.end;
+    if (!entry.elements.empty() || entry.size) {
+      e[SizeKey] = entry.size;
+      boost::json::array &elements = e[ElementsKey].emplace_array();
+      elements.reserve(entry.elements.size());
+      for (uint64_t offset : entry.elements) {
+        elements.push_back(offset);
+      }
+    }
+    if (!entry.classElements.empty()) {
+      boost::json::array &classElements = e[ClassElementsKey].emplace_array();
+      for (size_t i : entry.classElements) {
+        classElements.push_back(i);
+      }
+    }
+  }
+  JsonWriter writer(os);
+  writer.write(jv);
+  writer.flush();
+}
+
+const JsonIndex::Entry *JsonIndex::find(const std::string &name) const {
+  auto it = m_entries.find(name);
+  return it == m_entries.end() ? nullptr : &it->second;
+}
+
+JsonIndex::Entry &JsonIndex::add(const std::string &name) { return m_entries[name] = Entry(); }
+
+boost::json::value JsonIndex::value(std::string_view text, const std::string &name) const {
+  const Entry *entry = find(name);
+  if (!entry) {
+    throw std::runtime_error("Json index: member not found !");
+  }
+  boost::system::error_code ec;
+  const std::string_view member = slice(text, entry->offset, entry->end);
+  boost::json::value jv = boost::json::parse(boost::json::string_view(member.data(), member.size()), ec);
+  if (ec) {
+    throw std::runtime_error("Json index does not match the document !");
+  }
+  return jv;
+}
+
+boost::json::array JsonIndex::chunk(std::string_view text, const Entry &entry, size_t k) const {
+  // The last chunk ends with the closing bracket of the array, the other ones with the separator preceding the next chunk.
+  const bool last_chunk = (k + 1 == entry.elements.size());
+  std::string_view elements = slice(text, entry.elements[k], last_chunk ? entry.end - 1 : entry.elements[k + 1]);
+  const size_t last = elements.find_last_not_of(" \t\r\n");
+  if (last != std::string_view::npos && elements[last] == ',') {
+    elements = elements.substr(0, last);
+  }
+  std::string array;
+  array.reserve(elements.size() + 2);
+  array.append(1, '[').append(elements).append(1, ']');
+  boost::system::error_code ec;
+  boost::json::value jv = boost::json::parse(array, ec);
+  if (ec || !jv.is_array()) {
+    throw std::runtime_error("Json index does not match the document !");
+  }
+  return std::move(jv.get_array());
+}
+
+boost::json::array JsonIndex::elements(std::string_view text, const std::string &name, size_t first, size_t count) const {
+  const Entry *entry = find(name);
+  if (!entry || first > entry->size || count > entry->size - first ||
+      entry->elements.size() != (entry->size + m_stride - 1) / m_stride) {
+    throw std::runtime_error("Json index: elements not found !");
+  }
+  boost::json::array out;
+  out.reserve(count);
+  for (size_t k = first / m_stride; count && k <= (first + count - 1) / m_stride; k++) {
+    boost::json::array part = chunk(text, *entry, k);
+    const size_t base = k * m_stride;
+    const size_t from = std::max(first, base) - base;
+    const size_t to = std::min(first + count, base + part.size()) - base;
+    for (size_t i = from; i < to; i++) {
+      out.push_back(std::move(part[i]));
+    }
+  }
+  if (out.size() != count) {
+    throw std::runtime_error("Json index does not match the document !");
+  }
+  return out;
+}
+
+boost::json::array JsonIndex::classElements(std::string_view text, const std::string &name, size_t first) const {
+  const Entry *entry = find(name);
+  if (!entry) {
+    throw std::runtime_error("Json index: elements not found !");
+  }
+  boost::json::array out;
+  boost::json::array part;
+  size_t k = entry->elements.size();
+  for (size_t i : entry->classElements) {
+    if (i >= first) {
+      break;
+    }
+    if (i / m_stride != k) {
+      k = i / m_stride;
+      if (k >= entry->elements.size()) {
+        throw std::runtime_error("Json index does not match the document !");
+      }
+      part = chunk(text, *entry, k);
+    }
+    if (i - k * m_stride >= part.size()) {
+      throw std::runtime_error("Json index does not match the document !");
+    }
+    out.push_back(part[i - k * m_stride]);
+  }
+  return out;
+}
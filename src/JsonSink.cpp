@@ -0,0 +1,24 @@
+#include "boost/JsonSink.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+void OStreamSink::write(std::string &buffer) {
+  if (!m_os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+    throw std::runtime_error("Json output stream failure !");
+  }
+}
+
+void OStreamSink::flush() {
+  if (!m_os.flush()) {
+    throw std::runtime_error("Json output stream failure !");
+  }
+}
+
+void MemorySink::write(std::string &buffer) {
+  if (buffer.size() > m_capacity - m_size) {
+    throw std::runtime_error("MemorySink: not enough room !");
+  }
+  std::memcpy(m_data + m_size, buffer.data(), buffer.size());
+  m_size += buffer.size();
+}
@@ -0,0 +1,263 @@
+#include "boost/JsonSnapshot.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+constexpr char Magic[4] = {'B', 'J', 'S', 'N'};
+constexpr uint32_t FormatVersion = 1;
+/**
+ * @brief Maximum nesting level of a decoded snapshot.
+ */
+constexpr size_t MaxDepth = 1024;
+
+enum Kind : uint8_t { Null, False, True, Int64, UInt64, Double, String, Array, Object };
+
+void store(std::string &out, size_t pos, uint64_t v, size_t bytes = 8) {
+  for (size_t b = 0; b < bytes; b++) {
+    out[pos + b] = static_cast<char>(v >> (8 * b));
+  }
+}
+
+void append(std::string &out, uint64_t v, size_t bytes = 8) {
+  const size_t pos = out.size();
+  out.resize(pos + bytes);
+  store(out, pos, v, bytes);
+}
+
+class Encoder {
+public:
+  explicit Encoder(std::string &out) : m_out{out} {}
+
+  /**
+   * @brief Encode a node.
+   * @param jv
+   * @return uint64_t Offset of the node.
+   */
+  uint64_t node(const boost::json::value &jv) {
+    const uint64_t offset = m_out.size();
+    switch (jv.kind()) {
+    case boost::json::kind::null:
+      m_out += static_cast<char>(Null);
+      break;
+    case boost::json::kind::bool_:
+      m_out += static_cast<char>(jv.get_bool() ? True : False);
+      break;
+    case boost::json::kind::int64:
+      m_out += static_cast<char>(Int64);
+      append(m_out, static_cast<uint64_t>(jv.get_int64()));
+      break;
+    case boost::json::kind::uint64:
+      // Same kind as the Json text parsed back (loads rely on it): int64 whenever the value fits.
+      m_out += static_cast<char>(jv.get_uint64() <= uint64_t(INT64_MAX) ? Int64 : UInt64);
+      append(m_out, jv.get_uint64());
+      break;
+    case boost::json::kind::double_: {
+      uint64_t bits;
+      const double d = jv.get_double();
+      std::memcpy(&bits, &d, sizeof(bits));
+      m_out += static_cast<char>(Double);
+      append(m_out, bits);
+      break;
+    }
+    case boost::json::kind::string:
+      string(jv.get_string());
+      break;
+    case boost::json::kind::array: {
+      auto const &arr = jv.get_array();
+      m_out += static_cast<char>(Array);
+      append(m_out, arr.size());
+      size_t slots = m_out.size();
+      m_out.resize(slots + 8 * arr.size());
+      for (auto const &v : arr) {
+        store(m_out, slots, node(v));
+        slots += 8;
+      }
+      break;
+    }
+    case boost::json::kind::object: {
+      auto const &obj = jv.get_object();
+      m_out += static_cast<char>(Object);
+      append(m_out, obj.size());
+      size_t slots = m_out.size();
+      m_out.resize(slots + 16 * obj.size());
+      for (auto const &member : obj) {
+        store(m_out, slots, string(member.key()));
+        store(m_out, slots + 8, node(member.value()));
+        slots += 16;
+      }
+      break;
+    }
+    }
+    return offset;
+  }
+
+private:
+  uint64_t string(boost::json::string_view str) {
+    const uint64_t offset = m_out.size();
+    m_out += static_cast<char>(String);
+    append(m_out, str.size());
+    m_out.append(str.data(), str.size());
+    return offset;
+  }
+
+  std::string &m_out;
+};
+
+class Decoder {
+public:
+  explicit Decoder(std::string_view data) : m_data{data} {}
+
+  uint64_t load(uint64_t offset, size_t bytes = 8) const {
+    check(offset, bytes);
+    uint64_t v = 0;
+    for (size_t b = 0; b < bytes; b++) {
+      v |= uint64_t(static_cast<uint8_t>(m_data[offset + b])) << (8 * b);
+    }
+    return v;
+  }
+
+  /**
+   * @brief Decode a node. Children (and member keys) must follow their parent slots and each other, as written by
+   * the encoder: a node is never decoded twice, decoding is linear in the snapshot size.
+   * @param offset
+   * @param jv
+   * @param depth
+   * @return uint64_t End offset of the node and its children.
+   */
+  uint64_t node(uint64_t offset, boost::json::value &jv, size_t depth) const {
+    if (depth > MaxDepth) {
+      fail();
+    }
+    switch (load(offset, 1)) {
+    case Null:
+      jv = nullptr;
+      return offset + 1;
+    case False:
+      jv = false;
+      return offset + 1;
+    case True:
+      jv = true;
+      return offset + 1;
+    case Int64:
+      jv = static_cast<int64_t>(load(offset + 1));
+      return offset + 9;
+    case UInt64:
+      jv = load(offset + 1);
+      return offset + 9;
+    case Double: {
+      const uint64_t bits = load(offset + 1);
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      jv = d;
+      return offset + 9;
+    }
+    case String: {
+      const boost::json::string_view str = string(offset);
+      jv.emplace_string().assign(str.data(), str.size());
+      return offset + 9 + str.size();
+    }
+    case Array: {
+      const uint64_t count = load(offset + 1);
+      check(offset + 9, count, 8);
+      boost::json::array &arr = jv.emplace_array();
+      arr.resize(count);
+      uint64_t end = offset + 9 + 8 * count;
+      for (uint64_t i = 0; i < count; i++) {
+        end = node(after(load(offset + 9 + 8 * i), end), arr[i], depth + 1);
+      }
+      return end;
+    }
+    case Object: {
+      const uint64_t count = load(offset + 1);
+      check(offset + 9, count, 16);
+      boost::json::object &obj = jv.emplace_object();
+      obj.reserve(count);
+      uint64_t end = offset + 9 + 16 * count;
+      for (uint64_t i = 0; i < count; i++) {
+        const uint64_t slot = offset + 9 + 16 * i;
+        const uint64_t key = after(load(slot), end);
+        const boost::json::string_view name = string(key);
+        end = node(after(load(slot + 8), key + 9 + name.size()), obj[name], depth + 1);
+      }
+      return end;
+    }
+    default:
+      fail();
+    }
+  }
+
+private:
+  [[noreturn]] static void fail() { throw std::runtime_error("Invalid Json snapshot !"); }
+
+  static uint64_t after(uint64_t offset, uint64_t end) {
+    if (offset < end) {
+      fail();
+    }
+    return offset;
+  }
+  void check(uint64_t offset, uint64_t bytes) const {
+    if (offset > m_data.size() || bytes > m_data.size() - offset) {
+      fail();
+    }
+  }
+  void check(uint64_t offset, uint64_t count, uint64_t size) const {
+    if (count > m_data.size() / size) {
+      fail();
+    }
+    check(offset, count * size);
+  }
+
+  boost::json::string_view string(uint64_t offset) const {
+    if (load(offset, 1) != String) {
+      fail();
+    }
+    const uint64_t size = load(offset + 1);
+    check(offset + 9, size);
+    return boost::json::string_view(m_data.data() + offset + 9, size);
+  }
+
+  std::string_view m_data;
+};
+} // namespace
+
+std::string JsonSnapshot::encode(const boost::json::value &jv) {
+  std::string out(Magic, sizeof(Magic));
+  append(out, FormatVersion, 4);
+  out.resize(HeaderSize);
+  const uint64_t root = Encoder(out).node(jv);
+  store(out, 8, out.size());
+  store(out, 16, root);
+  return out;
+}
+
+void JsonSnapshot::write(const boost::json::value &jv, JsonSink &sink) {
+  std::string snapshot = encode(jv);
+  sink.write(snapshot);
+}
+
+bool JsonSnapshot::isSnapshot(std::string_view data) {
+  return data.size() >= sizeof(Magic) && std::memcmp(data.data(), Magic, sizeof(Magic)) == 0;
+}
+
+boost::json::value JsonSnapshot::decode(std::string_view data, boost::json::storage_ptr sp) {
+  if (data.size() < HeaderSize || !isSnapshot(data)) {
+    throw std::runtime_error("Invalid Json snapshot !");
+  }
+  Decoder decoder(data);
+  if (decoder.load(4, 4) != FormatVersion) {
+    throw std::runtime_error("Unsupported Json snapshot version !");
+  }
+  const uint64_t size = decoder.load(8);
+  if (size > data.size()) {
+    throw std::runtime_error("Truncated Json snapshot !");
+  }
+  const uint64_t root = decoder.load(16);
+  if (root < HeaderSize) {
+    throw std::runtime_error("Invalid Json snapshot !");
+  }
+  boost::json::value jv(std::move(sp));
+  Decoder(data.substr(0, size)).node(root, jv, 0);
+  return jv;
+}
@@ -0,0 +1,11 @@
+#include "boost/JsonSource.hpp"
+
+#include <stdexcept>
+
+size_t IStreamSource::read(char *data, size_t size) {
+  m_is.read(data, static_cast<std::streamsize>(size));
+  if (m_is.bad()) {
+    throw std::runtime_error("Json input stream failure !");
+  }
+  return static_cast<size_t>(m_is.gcount());
+}
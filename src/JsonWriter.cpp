@@ -0,0 +1,380 @@
+#include "boost/JsonWriter.hpp"
+#include "boost/JsonContext.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <vector>
+
+namespace {
+constexpr bool metadataKeysArePlain() {
+  for (const JsonKey &key : param::MetadataKeys) {
+    if (!key.plain()) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(metadataKeysArePlain(), "Metadata keys must not need escaping !");
+} // namespace
+
+JsonWriter::JsonWriter(std::ostream &os, bool prettify, size_t bufferSize)
+    : JsonWriter(std::make_unique<OStreamSink>(os), nullptr, prettify, bufferSize) {}
+
+JsonWriter::JsonWriter(JsonSink &sink, bool prettify, size_t bufferSize) : JsonWriter(nullptr, &sink, prettify, bufferSize) {}
+
+JsonWriter::JsonWriter(std::unique_ptr<JsonSink> streamSink, JsonSink *sink, bool prettify, size_t bufferSize)
+    : m_streamSink{std::move(streamSink)}, m_sink{sink ? *sink : *m_streamSink}, m_prettify{prettify},
+      m_bufferSize{bufferSize} {
+  m_buffer.reserve(m_bufferSize);
+  for (const JsonKey &key : param::MetadataKeys) {
+    cacheKey(key);
+  }
+}
+
+void JsonWriter::write(const boost::json::value &jv) {
+  writeValue(jv);
+  if (m_prettify) {
+    append("\n", 1);
+  }
+}
+
+void JsonWriter::writeLine(const boost::json::value &jv) {
+  writeValue(jv);
+  append("\n", 1);
+}
+
+void JsonWriter::beginObject() {
+  append(m_prettify ? "{\n" : "{");
+  if (m_prettify) {
+    m_indent.append(4, ' ');
+  }
+  m_first = true;
+}
+
+void JsonWriter::writeMember(boost::json::string_view key, const boost::json::value &jv) {
+  if (!m_first) {
+    append(m_prettify ? ",\n" : ",");
+  }
+  m_first = false;
+  append(m_indent);
+  writeKey(key);
+  writeValue(jv);
+}
+
+void JsonWriter::writeMember(boost::json::string_view key, const boost::json::value &jv, JsonIndex &index) {
+  if (!m_first) {
+    append(m_prettify ? ",\n" : ",");
+  }
+  m_first = false;
+  append(m_indent);
+  writeKey(key);
+  JsonIndex::Entry &entry = index.add(std::string(key));
+  entry.offset = written();
+  if (jv.is_array()) {
+    writeArray(jv.get_array(), &entry, index.stride());
+    for (size_t i = 0; i < jv.get_array().size(); i++) {
+      if (JsonContext::hasClassInfo(jv.get_array()[i])) {
+        entry.classElements.push_back(i);
+      }
+    }
+  } else {
+    writeValue(jv);
+  }
+  entry.end = written();
+}
+
+void JsonWriter::endObject() {
+  if (m_prettify) {
+    m_indent.resize(m_indent.size() - 4);
+    append("\n", 1);
+    append(m_indent);
+  }
+  append("}", 1);
+  if (m_prettify) {
+    append("\n", 1);
+  }
+}
+
+void JsonWriter::flush() {
+  if (!m_buffer.empty()) {
+    m_written += m_buffer.size();
+    m_sink.write(m_buffer);
+    m_buffer.clear();
+    m_buffer.reserve(m_bufferSize);
+  }
+}
+
+void JsonWriter::append(const char *data, size_t size) {
+  if (m_buffer.size() + size > m_bufferSize) {
+    flush();
+  }
+  m_buffer.append(data, size);
+}
+
+void JsonWriter::cacheKey(JsonKey key) {
+  if (!key.plain() || m_keys.size() >= MaxCachedKeys) {
+    return;
+  }
+  std::string &token = m_tokens.emplace_back();
+  token.reserve(key.name().size() + 5);
+  token.append(1, '"').append(key.name()).append(m_prettify ? "\" : " : "\":");
+  m_keys.emplace(std::string_view(token).substr(1, key.name().size()), token);
+}
+
+void JsonWriter::writeKey(boost::json::string_view key) {
+  const std::string_view raw(key.data(), key.size());
+  auto it = m_keys.find(raw);
+  if (it == m_keys.end()) {
+    cacheKey(JsonKey(raw));
+    it = m_keys.find(raw);
+  }
+  if (it != m_keys.end()) {
+    append(it->second);
+    return;
+  }
+  writeString(key);
+  append(m_prettify ? " : " : ":");
+}
+
+void JsonWriter::writeString(boost::json::string_view str) {
+  const std::string_view raw(str.data(), str.size());
+  if (JsonKey::isPlain(raw)) {
+    append("\"", 1);
+    append(raw);
+    append("\"", 1);
+  } else {
+    append(boost::json::serialize(str));
+  }
+}
+
+std::string_view JsonWriter::formatDouble(double d) {
+  if (m_canonical && d == 0) {
+    d = 0;
+  }
+  if (m_prettify) {
+    // Same conversion as std::ostream << d (sink stream flags and precision).
+    const std::ios_base::fmtflags flags = m_sink.flags();
+    const std::ios_base::fmtflags field = flags & std::ios_base::floatfield;
+    const bool upper = flags & std::ios_base::uppercase;
+    char format[8];
+    char *f = format;
+    *f++ = '%';
+    if (flags & std::ios_base::showpos) {
+      *f++ = '+';
+    }
+    if (flags & std::ios_base::showpoint) {
+      *f++ = '#';
+    }
+    const bool hex = field == (std::ios_base::fixed | std::ios_base::scientific);
+    if (!hex) {
+      *f++ = '.';
+      *f++ = '*';
+    }
+    if (field == std::ios_base::fixed) {
+      *f++ = upper ? 'F' : 'f';
+    } else if (field == std::ios_base::scientific) {
+      *f++ = upper ? 'E' : 'e';
+    } else if (hex) {
+      *f++ = upper ? 'A' : 'a';
+    } else {
+      *f++ = upper ? 'G' : 'g';
+    }
+    *f = '\0';
+    const int precision = m_sink.precision();
+    auto print = [&](size_t size) {
+      // std::string keeps room for the terminating null.
+      return static_cast<size_t>(hex ? std::snprintf(m_number.data(), size + 1, format, d)
+                                     : std::snprintf(m_number.data(), size + 1, format, precision, d));
+    };
+    m_number.resize(NumberSize);
+    const size_t size = print(m_number.size());
+    if (size > m_number.size()) {
+      // Large fixed notation numbers, or high precisions.
+      m_number.resize(size);
+      print(size);
+    }
+    m_number.resize(size);
+    return m_number;
+  }
+  boost::json::value jv(d);
+  m_serializer.reset(&jv);
+  m_number.resize(NumberSize);
+  m_number.resize(m_serializer.read(m_number.data(), m_number.size()).size());
+  return m_number;
+}
+
+void JsonWriter::writeDouble(double d) { append(formatDouble(d)); }
+
+template <typename T> void JsonWriter::writeInteger(T i) {
+  char buf[24];
+  auto res = std::to_chars(buf, buf + sizeof(buf), i);
+  append(buf, static_cast<size_t>(res.ptr - buf));
+}
+
+size_t JsonWriter::size(const boost::json::value &jv) { return valueSize(jv, 0) + (m_prettify ? 1 : 0); }
+
+size_t JsonWriter::stringSize(boost::json::string_view str) {
+  const std::string_view raw(str.data(), str.size());
+  return JsonKey::isPlain(raw) ? raw.size() + 2 : boost::json::serialize(str).size();
+}
+
+size_t JsonWriter::valueSize(const boost::json::value &jv, size_t depth) {
+  switch (jv.kind()) {
+  case boost::json::kind::object:
+  case boost::json::kind::array: {
+    const size_t count = jv.is_object() ? jv.get_object().size() : jv.get_array().size();
+    // Brackets, separators, then (prettified) line breaks and indentation.
+    const size_t separators = count ? count - 1 : 0;
+    size_t size = 2 + separators;
+    if (m_prettify) {
+      size += 2 + separators + count * (depth + 1) * 4 + depth * 4;
+    }
+    if (jv.is_object()) {
+      for (auto const &member : jv.get_object()) {
+        size += stringSize(member.key()) + (m_prettify ? 3 : 1) + valueSize(member.value(), depth + 1);
+      }
+    } else {
+      for (auto const &v : jv.get_array()) {
+        size += valueSize(v, depth + 1);
+      }
+    }
+    return size;
+  }
+
+  case boost::json::kind::string:
+    return stringSize(jv.get_string());
+
+  case boost::json::kind::uint64: {
+    char buf[24];
+    return static_cast<size_t>(std::to_chars(buf, buf + sizeof(buf), jv.get_uint64()).ptr - buf);
+  }
+
+  case boost::json::kind::int64: {
+    char buf[24];
+    return static_cast<size_t>(std::to_chars(buf, buf + sizeof(buf), jv.get_int64()).ptr - buf);
+  }
+
+  case boost::json::kind::double_:
+    return formatDouble(jv.get_double()).size();
+
+  case boost::json::kind::bool_:
+    return jv.get_bool() ? 4 : 5;
+
+  case boost::json::kind::null:
+    return 4;
+  }
+  return 0;
+}
+
+void JsonWriter::writeArray(const boost::json::array &arr, JsonIndex::Entry *entry, size_t stride) {
+  append(m_prettify ? "[\n" : "[");
+  if (m_prettify) {
+    m_indent.append(4, ' ');
+  }
+  if (entry) {
+    entry->size = arr.size();
+    entry->elements.reserve((arr.size() + stride - 1) / stride);
+  }
+  for (size_t i = 0; i < arr.size(); i++) {
+    if (i) {
+      append(m_prettify ? ",\n" : ",");
+    }
+    append(m_indent);
+    if (entry && i % stride == 0) {
+      entry->elements.push_back(written());
+    }
+    writeValue(arr[i]);
+  }
+  if (m_prettify) {
+    m_indent.resize(m_indent.size() - 4);
+    append("\n", 1);
+    append(m_indent);
+  }
+  append("]", 1);
+}
+
+void JsonWriter::writeObject(const boost::json::object &obj) {
+  std::vector<const boost::json::key_value_pair *> sorted;
+  if (m_canonical) {
+    auto byKey = [](const boost::json::key_value_pair &a, const boost::json::key_value_pair &b) {
+      const boost::json::string_view ka = a.key(), kb = b.key();
+      return std::string_view(ka.data(), ka.size()) < std::string_view(kb.data(), kb.size());
+    };
+    if (!std::is_sorted(obj.begin(), obj.end(), byKey)) {
+      sorted.reserve(obj.size());
+      for (auto const &member : obj) {
+        sorted.push_back(&member);
+      }
+      std::sort(sorted.begin(), sorted.end(), [&](auto a, auto b) { return byKey(*a, *b); });
+    }
+  }
+  append(m_prettify ? "{\n" : "{");
+  if (m_prettify) {
+    m_indent.append(4, ' ');
+  }
+  bool first = true;
+  auto writeMember = [&](const boost::json::key_value_pair &member) {
+    if (!first) {
+      append(m_prettify ? ",\n" : ",");
+    }
+    first = false;
+    append(m_indent);
+    writeKey(member.key());
+    writeValue(member.value());
+  };
+  if (sorted.empty()) {
+    for (auto const &member : obj) {
+      writeMember(member);
+    }
+  } else {
+    for (auto member : sorted) {
+      writeMember(*member);
+    }
+  }
+  if (m_prettify) {
+    m_indent.resize(m_indent.size() - 4);
+    append("\n", 1);
+    append(m_indent);
+  }
+  append("}", 1);
+}
+
+void JsonWriter::writeValue(const boost::json::value &jv) {
+  switch (jv.kind()) {
+  case boost::json::kind::object:
+    writeObject(jv.get_object());
+    break;
+
+  case boost::json::kind::array:
+    writeArray(jv.get_array());
+    break;
+
+  case boost::json::kind::string:
+    writeString(jv.get_string());
+    break;
+
+  case boost::json::kind::uint64:
+    writeInteger(jv.get_uint64());
+    break;
+
+  case boost::json::kind::int64:
+    writeInteger(jv.get_int64());
+    break;
+
+  case boost::json::kind::double_:
+    writeDouble(jv.get_double());
+    break;
+
+  case boost::json::kind::bool_:
+    if (jv.get_bool())
+      append("true", 4);
+    else
+      append("false", 5);
+    break;
+
+  case boost::json::kind::null:
+    append("null", 4);
+    break;
+  }
+}
@@ -0,0 +1,45 @@
+#include "boost/MappedFile.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("MappedFile: cannot open file: ") + std::strerror(errno));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    const int error = errno;
+    ::close(fd);
+    throw std::runtime_error(std::string("MappedFile: cannot stat file: ") + std::strerror(error));
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  if (m_size) {
+    void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      throw std::runtime_error(std::string("MappedFile: cannot map file: ") + std::strerror(error));
+    }
+    m_data = static_cast<const char *>(data);
+  }
+  // The mapping stays valid once the file is closed.
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (m_data) {
+    ::munmap(const_cast<char *>(m_data), m_size);
+  }
+}
+
+#endif
@@ -0,0 +1,76 @@
+#include "boost/ReadAheadSource.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+ReadAheadSource::ReadAheadSource(JsonSource &source, size_t blocks, size_t blockSize)
+    : m_source{source}, m_capacity{std::max<size_t>(blocks, 1)}, m_blockSize{std::max<size_t>(blockSize, 1)},
+      m_thread{&ReadAheadSource::run, this} {}
+
+ReadAheadSource::~ReadAheadSource() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  m_thread.join();
+}
+
+size_t ReadAheadSource::read(char *data, size_t size) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this]() { return !m_blocks.empty() || m_end; });
+  if (m_blocks.empty()) {
+    if (m_error) {
+      std::rethrow_exception(m_error);
+    }
+    return 0;
+  }
+  std::string &block = m_blocks.front();
+  const size_t n = std::min(size, block.size() - m_offset);
+  std::memcpy(data, block.data() + m_offset, n);
+  m_offset += n;
+  if (m_offset == block.size()) {
+    m_free.push_back(std::move(block));
+    m_blocks.pop_front();
+    m_offset = 0;
+    lock.unlock();
+    m_cv.notify_all();
+  }
+  return n;
+}
+
+void ReadAheadSource::run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_cv.wait(lock, [this]() { return m_stop || m_blocks.size() < m_capacity; });
+    if (m_stop) {
+      return;
+    }
+    std::string block;
+    if (!m_free.empty()) {
+      block = std::move(m_free.back());
+      m_free.pop_back();
+    }
+    lock.unlock();
+    block.resize(m_blockSize);
+    size_t n = 0;
+    std::exception_ptr error;
+    try {
+      n = m_source.read(&block[0], block.size());
+    } catch (...) {
+      error = std::current_exception();
+    }
+    block.resize(n);
+    lock.lock();
+    if (n > 0) {
+      m_blocks.push_back(std::move(block));
+    } else {
+      m_error = error;
+      m_end = true;
+    }
+    m_cv.notify_all();
+    if (m_end) {
+      return;
+    }
+  }
+}
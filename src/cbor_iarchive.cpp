@@ -0,0 +1,20 @@
+// C++ Standard Library
+#include <iterator>
+#include <string>
+
+// Boost Archive JSON
+#include "boost/archive/cbor_iarchive.hpp"
+#include "boost/JsonCbor.hpp"
+
+namespace boost {
+namespace archive {
+
+cbor_iarchive::cbor_iarchive(std::istream &is, unsigned int flags)
+    : json_iarchive(JsonCbor::decode(std::string(std::istreambuf_iterator<char>(is), {})), flags) {}
+
+cbor_iarchive::cbor_iarchive(JsonSource &source, unsigned int flags) : json_iarchive(JsonCbor::read(source), flags) {}
+
+cbor_iarchive::cbor_iarchive(std::string_view data, unsigned int flags) : json_iarchive(JsonCbor::decode(data), flags) {}
+
+} // namespace archive
+} // namespace boost
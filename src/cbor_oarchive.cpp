@@ -0,0 +1,12 @@
+// Boost Archive JSON
+#include "boost/archive/cbor_oarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+cbor_oarchive::cbor_oarchive(std::ostream &os, unsigned int flags) : json_oarchive(os, flags) { m_encoding = encoding::cbor; }
+
+cbor_oarchive::cbor_oarchive(JsonSink &sink, unsigned int flags) : json_oarchive(sink, flags) { m_encoding = encoding::cbor; }
+
+} // namespace archive
+} // namespace boost
@@ -7,36 +7,160 @@
 // Boost Archive JSON
 #include "boost/archive/json_iarchive.hpp"
 
+#include <cstring>
 #include <iostream>
 
 namespace boost {
 namespace archive {
 
-json_iarchive::json_iarchive(std::istream &is, unsigned int) : m_ctx() {
+json_iarchive::json_iarchive(std::istream &is, unsigned int flags) : detail::common_iarchive<json_iarchive>(flags), m_ctx() {
   boost::system::error_code ec;
   root_value = JsonContext::parse(is, ec);
   if (ec) {
     throw std::runtime_error("Input stream is not Json Friendly...");
   }
+  init_string_table();
+}
+
+json_iarchive::json_iarchive(JsonSource &source, unsigned int flags) : detail::common_iarchive<json_iarchive>(flags), m_ctx() {
+  boost::system::error_code ec;
+  root_value = JsonContext::parse(source, ec);
+  if (ec) {
+    throw std::runtime_error("Input stream is not Json Friendly...");
+  }
+  init_string_table();
+}
+
+json_iarchive::json_iarchive(std::string_view data, unsigned int flags) : detail::common_iarchive<json_iarchive>(flags), m_ctx() {
+  if (JsonSnapshot::isSnapshot(data)) {
+    root_value = JsonSnapshot::decode(data);
+  } else {
+    boost::system::error_code ec;
+    root_value = boost::json::parse(boost::json::string_view(data.data(), data.size()), ec);
+    if (ec) {
+      throw std::runtime_error("Input stream is not Json Friendly...");
+    }
+  }
+  init_string_table();
+}
+
+json_iarchive::json_iarchive(JsonSource &source, const std::string &pointer, unsigned int flags)
+    : json_iarchive(project(source, pointer), flags) {}
+
+json_iarchive::json_iarchive(std::istream &is, const std::string &pointer, unsigned int flags)
+    : json_iarchive(project(is, pointer), flags) {}
+
+json_iarchive::json_iarchive(std::string_view text, const JsonIndex &index, const std::string &name, size_t first,
+                             size_t count, unsigned int flags)
+    : json_iarchive(indexed(text, index, name, first, count), flags) {
+  m_class_elements = index.classElements(text, name, first);
+  if (JsonContext::hasReferences(root_value) || JsonContext::hasReferences(m_class_elements)) {
+    throw std::runtime_error("Json index: elements with pointers or object references cannot be loaded alone !");
+  }
+  m_class_elements_of = &root_value.get_object().at(name);
+}
+
+json_iarchive::json_iarchive(std::shared_ptr<const JsonDocument> document, const std::string &pointer, unsigned int flags)
+    : detail::common_iarchive<json_iarchive>(flags), m_document(std::move(document)), m_ctx() {
+  m_input = m_document->find(pointer);
+  if (!m_input) {
+    throw std::runtime_error("Json pointer not found !");
+  }
+  if (this->get_flags() & json_string_table) {
+    m_ctx.setStringTable(m_document->stringTable());
+  }
+  init_string_table();
+}
+
+json_iarchive::json_iarchive(boost::json::value &&root, unsigned int flags)
+    : detail::common_iarchive<json_iarchive>(flags), root_value(std::move(root)), m_ctx() {
+  init_string_table();
+}
+
+json_iarchive::json_iarchive(unsigned int flags, const boost::json::array *string_table)
+    : detail::common_iarchive<json_iarchive>(flags), m_ctx() {
+  m_ctx.setRoot("", std::make_shared<boost::json::value>(boost::json::array()));
+  m_ctx.setStringTable(string_table);
+}
+
+boost::json::value json_iarchive::project(JsonSource &source, const std::string &pointer) {
+  boost::json::value projection;
+  if (!JsonContext::project(source, pointer, projection)) {
+    throw std::runtime_error("Json pointer not found !");
+  }
+  return projection;
+}
+
+boost::json::value json_iarchive::project(std::istream &is, const std::string &pointer) {
+  IStreamSource source{is};
+  return project(source, pointer);
+}
+
+boost::json::value json_iarchive::indexed(std::string_view text, const JsonIndex &index, const std::string &name,
+                                          size_t first, size_t count) {
+  boost::json::value document;
+  boost::json::object &o = document.emplace_object();
+  o[name] = index.elements(text, name, first, count);
+  if (index.find(param::StringTableType)) {
+    o[param::StringTableType] = index.value(text, param::StringTableType);
+  }
+  return document;
+}
+
+void json_iarchive::init_string_table() {
+  if (!(this->get_flags() & json_string_table)) {
+    return;
+  }
+  if (auto const *obj = m_input->if_object()) {
+    if (auto const *table = obj->if_contains(param::StringTableType); table && table->is_array()) {
+      m_ctx.setStringTable(&table->get_array());
+    }
+  }
+}
+
+const boost::json::value &json_iarchive::metadata(const std::string &key) {
+  // The loaded tree is shared (documents): it is never modified.
+  static const boost::json::value null;
+  auto const *found = member_of(*m_ctx.current().second, key);
+  return found ? *found : null;
 }
 
 void json_iarchive::load_override(class_name_type &t) {
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ClassNameType];
+  const boost::json::value &data = m_ctx.resolve(metadata(param::ClassNameType));
 
   if (!data.is_string()) {
     return;
   }
 
-  std::strcpy((char *)t, data.as_string().c_str());
+  const boost::json::string &name = data.get_string();
+  if (name.size() >= BOOST_SERIALIZATION_MAX_KEY_SIZE) {
+    throw std::runtime_error("Json class name too long !");
+  }
+  std::memcpy(static_cast<char *>(t), name.data(), name.size());
+  static_cast<char *>(t)[name.size()] = '\0';
+}
+
+bool json_iarchive::load_chars(char *buffer, size_t size) {
+  const boost::json::value &data = m_ctx.resolve(*m_ctx.top().second);
+  if (!data.is_string()) {
+    return false;
+  }
+  const boost::json::string &str = data.get_string();
+  if (str.size() >= size) {
+    throw std::runtime_error("Json string too long for its buffer !");
+  }
+  std::memcpy(buffer, str.data(), str.size());
+  buffer[str.size()] = '\0';
+  return true;
 }
 
 void json_iarchive::load_override(version_type &t) {
-  boost::json::value &data = m_ctx.current().second->get_object()[param::VersionType];
+  const boost::json::value &data = metadata(param::VersionType);
   t = version_type(static_cast<uint64_t>(data.as_int64()));
 }
 
 void json_iarchive::load_override(object_id_type &t) {
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ObjectIdType];
+  const boost::json::value &data = metadata(param::ObjectIdType);
   if (!data.is_number()) {
     object_reference_type r(object_id_type(0));
     load_override(r);
@@ -48,7 +172,7 @@ void json_iarchive::load_override(object_id_type &t) {
 }
 
 void json_iarchive::load_override(object_reference_type &t) {
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ObjectReferenceType];
+  const boost::json::value &data = metadata(param::ObjectReferenceType);
   if (!data.is_number()) {
     return;
   }
@@ -60,7 +184,7 @@ void json_iarchive::load_override(class_id_type &t) {
   if (m_ctx.current().second->kind() != json::kind::object) {
     m_ctx.pop();
   }
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ClassIdType];
+  const boost::json::value &data = metadata(param::ClassIdType);
   if (!data.is_number()) {
     class_id_reference_type r(class_id_type(0));
     load_override(r);
@@ -75,7 +199,7 @@ void json_iarchive::load_override(class_id_optional_type &t) {
   if (m_ctx.current().second->kind() != json::kind::object) {
     m_ctx.pop();
   }
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ClassIdOptionalType];
+  const boost::json::value &data = metadata(param::ClassIdOptionalType);
 
   if (!data.is_number()) {
     return;
@@ -88,7 +212,7 @@ void json_iarchive::load_override(class_id_reference_type &t) {
   if (m_ctx.current().second->kind() != json::kind::object) {
     m_ctx.pop();
   }
-  boost::json::value &data = m_ctx.current().second->get_object()[param::ClassIdReferenceType];
+  const boost::json::value &data = metadata(param::ClassIdReferenceType);
   if (!data.is_number()) {
     return;
   }
@@ -99,7 +223,7 @@ void json_iarchive::load_override(tracking_type &t) {
   if (m_ctx.current().second->kind() != json::kind::object) {
     m_ctx.pop();
   }
-  boost::json::value &data = m_ctx.current().second->get_object()[param::TrackingType];
+  const boost::json::value &data = metadata(param::TrackingType);
 
   if (!data.is_bool()) {
     return;
@@ -0,0 +1,43 @@
+// Boost Archive JSON
+#include "boost/archive/json_lines_iarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+namespace {
+bool isBlank(const std::string &line) { return line.find_first_not_of(" \t\r") == std::string::npos; }
+} // namespace
+
+// Records may be loaded on the thread pool: they must not wait on other pool tasks (json_parallel).
+json_lines_iarchive::json_lines_iarchive(std::istream &is, unsigned int flags)
+    : m_is{is}, m_flags{flags & ~static_cast<unsigned int>(json_parallel)} {}
+
+bool json_lines_iarchive::next_line(std::string &line) {
+  for (;;) {
+    size_t eol = m_buffer.find('\n', m_scan);
+    if (eol != std::string::npos) {
+      line.assign(m_buffer, m_pos, eol - m_pos);
+      m_pos = m_scan = eol + 1;
+      if (!isBlank(line)) {
+        return true;
+      }
+      continue;
+    }
+    if (m_eof) {
+      line.assign(m_buffer, m_pos, std::string::npos);
+      m_buffer.clear();
+      m_pos = m_scan = 0;
+      return !isBlank(line);
+    }
+    m_buffer.erase(0, m_pos);
+    m_pos = 0;
+    m_scan = m_buffer.size();
+    m_buffer.resize(m_scan + BlockSize);
+    m_is.read(&m_buffer[m_scan], BlockSize);
+    m_buffer.resize(m_scan + static_cast<size_t>(m_is.gcount()));
+    m_eof = !m_is;
+  }
+}
+
+} // namespace archive
+} // namespace boost
@@ -0,0 +1,83 @@
+// Boost Archive JSON
+#include "boost/archive/json_lines_oarchive.hpp"
+
+namespace boost {
+namespace archive {
+
+// Records may be saved on the thread pool: they must not wait on other pool tasks (json_parallel).
+json_lines_oarchive::json_lines_oarchive(std::ostream &os, unsigned int flags)
+    : m_os{os}, m_flags{flags & ~static_cast<unsigned int>(json_parallel)}, m_writer{os, false} {}
+
+json_lines_oarchive::~json_lines_oarchive() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  wait(lock);
+  try {
+    m_os.flush();
+  } catch (...) {
+  }
+}
+
+void json_lines_oarchive::flush() {
+  std::exception_ptr error;
+  bool failed = false;
+  {
+    // Records started meanwhile are written to the stream under the same lock.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    wait(lock);
+    m_os.flush();
+    failed = !m_os;
+    std::swap(error, m_error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if (failed) {
+    throw std::runtime_error("Json Lines output stream failure !");
+  }
+}
+
+uint64_t json_lines_oarchive::take_ticket() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_tickets++;
+}
+
+void json_lines_oarchive::complete(uint64_t ticket, std::optional<boost::json::value> record) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_ready.emplace(ticket, std::move(record));
+  while (!m_ready.empty() && m_ready.begin()->first == m_written) {
+    std::optional<boost::json::value> next = std::move(m_ready.begin()->second);
+    m_ready.erase(m_ready.begin());
+    m_written++;
+    try {
+      if (next) {
+        m_writer.writeLine(*next);
+      }
+    } catch (...) {
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+    }
+  }
+  try {
+    m_writer.flush();
+  } catch (...) {
+    if (!m_error) {
+      m_error = std::current_exception();
+    }
+  }
+  m_cv.notify_all();
+}
+
+void json_lines_oarchive::fail(std::exception_ptr error) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_error) {
+    m_error = error;
+  }
+}
+
+void json_lines_oarchive::wait(std::unique_lock<std::mutex> &lock) {
+  m_cv.wait(lock, [this]() { return m_written == m_tickets; });
+}
+
+} // namespace archive
+} // namespace boost
@@ -7,16 +7,237 @@
 #include <boost/archive/impl/archive_serializer_map.ipp>
 
 // Boost Archive JSON
+#include "boost/DigestSink.hpp"
 #include "boost/archive/json_oarchive.hpp"
 
+namespace {
+/**
+ * @brief Return true for the keys written by the archive itself (never deleted by a merge patch).
+ * @param key
+ * @return true
+ * @return false
+ */
+bool isClassInfoKey(std::string_view key) {
+  for (const JsonKey &k : {param::ClassNameKey, param::VersionKey, param::ItemVersionKey, param::ObjectIdKey,
+                           param::ObjectReferenceKey, param::ClassIdKey, param::ClassIdOptionalKey,
+                           param::ClassIdReferenceKey, param::TrackingKey}) {
+    if (k.name() == key) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
+
 namespace boost {
 namespace archive {
 
-json_oarchive::json_oarchive(std::ostream &os, unsigned int, const bool prettify) : m_ctx{}, os_{os}, prettify_{prettify} {}
+json_oarchive::json_oarchive(std::ostream &os, unsigned int flags, const bool prettify)
+    : detail::common_oarchive<json_oarchive>(flags), m_ctx{}, m_stream_sink{std::make_unique<OStreamSink>(os)},
+      sink_{m_stream_sink.get()}, prettify_{prettify} {}
+
+json_oarchive::json_oarchive(JsonSink &sink, unsigned int flags, const bool prettify)
+    : detail::common_oarchive<json_oarchive>(flags), m_ctx{}, sink_{&sink}, prettify_{prettify} {}
+
+json_oarchive::json_oarchive(unsigned int flags) : detail::common_oarchive<json_oarchive>(flags), m_ctx{}, sink_{nullptr} {}
+
+json_oarchive::~json_oarchive() {
+  try {
+    finish();
+  } catch (...) {
+  }
+}
+
+void json_oarchive::flush() {
+  if (!sink_ || m_finished) {
+    return;
+  }
+  write_members();
+  if (m_writer) {
+    m_writer->flush();
+  }
+  sink_->flush();
+}
+
+void json_oarchive::finish() {
+  if (!sink_ || m_finished) {
+    return;
+  }
+  m_finished = true;
+  if (m_baseline && m_ctx.root() && m_ctx.root()->is_object()) {
+    delete_missing(m_ctx.root()->get_object(), m_baseline_frames.front());
+  }
+  const boost::json::value &document = m_ctx.document();
+  if (whole_document()) {
+    write_encoded(document, *sink_);
+  } else if (m_writer || (m_index && m_ctx.root()->is_object())) {
+    write_members();
+    m_writer->endObject();
+    m_writer->flush();
+  } else {
+    JsonWriter writer(*sink_, prettify_);
+    writer.write(document);
+    writer.flush();
+  }
+  sink_->finish();
+}
+
+size_t json_oarchive::measure() {
+  if (m_writer) {
+    throw std::runtime_error("Json output already started !");
+  }
+  if (whole_document()) {
+    std::string encoded;
+    StringSink sink{encoded};
+    write_encoded(m_ctx.document(), sink);
+    return encoded.size();
+  }
+  // Nothing is written: the writer is only used for its formatting rules (and the sink precision).
+  std::string unused;
+  StringSink detached{unused};
+  JsonWriter writer(sink_ ? *sink_ : static_cast<JsonSink &>(detached), prettify_, 0);
+  return writer.size(m_ctx.document());
+}
+
+void json_oarchive::write_snapshot(JsonSink &sink) {
+  if (m_writer) {
+    throw std::runtime_error("Json output already started !");
+  }
+  JsonSnapshot::write(m_ctx.document(), sink);
+}
+
+uint64_t json_oarchive::digest() {
+  if (m_writer) {
+    throw std::runtime_error("Json output already started !");
+  }
+  DigestSink sink;
+  JsonWriter writer(sink);
+  writer.setCanonical(true);
+  writer.write(m_ctx.document());
+  writer.flush();
+  return sink.digest();
+}
+
+void json_oarchive::write_encoded(const boost::json::value &document, JsonSink &sink) const {
+  if (m_encoding == encoding::cbor) {
+    JsonCbor::write(document, sink);
+  } else if (this->get_flags() & json_snapshot) {
+    JsonSnapshot::write(document, sink);
+  } else {
+    JsonWriter writer(sink);
+    writer.setCanonical(true);
+    writer.write(document);
+    writer.flush();
+  }
+}
+
+void json_oarchive::write_members() {
+  if (!sink_ || !m_ctx.root()->is_object() || whole_document()) {
+    return;
+  }
+  if (!m_writer) {
+    m_writer = std::make_unique<JsonWriter>(*sink_, prettify_, m_flush_threshold ? m_flush_threshold : JsonWriter::BufferSize);
+    m_writer->beginObject();
+  }
+  boost::json::object &root = m_ctx.root()->get_object();
+  for (auto const &member : root) {
+    if (m_index) {
+      m_writer->writeMember(member.key(), member.value(), *m_index);
+    } else {
+      m_writer->writeMember(member.key(), member.value());
+    }
+  }
+  root.clear();
+}
+
+void json_oarchive::set_baseline(const boost::json::value &baseline) {
+  if (this->get_flags() & (json_string_table | json_elide_defaults)) {
+    throw std::runtime_error("Json merge patch is not available with string table or elided defaults !");
+  }
+  m_baseline = &baseline;
+  m_baseline_frames.assign(1, baseline_frame{&baseline, {}});
+}
 
-json_oarchive::~json_oarchive() { m_ctx.serialize(os_, prettify_); }
+void json_oarchive::set_baseline(std::shared_ptr<const JsonDocument> baseline) {
+  set_baseline(baseline->root());
+  m_baseline_document = std::move(baseline);
+}
 
-void json_oarchive::save_override(const class_name_type &t) { m_ctx.current().second->as_object()[param::ClassNameType] = t.t; }
+void json_oarchive::push_baseline(bool in_object, boost::json::string_view name) {
+  const boost::json::value *parent = m_baseline_frames.back().base;
+  const boost::json::value *base = nullptr;
+  // Arrays are replaced as a whole: no baseline inside them.
+  if (in_object && parent && parent->is_object()) {
+    base = parent->get_object().if_contains(name);
+  }
+  m_baseline_frames.push_back(baseline_frame{base, {}});
+}
+
+void json_oarchive::pop_baseline(boost::json::value *container, boost::json::string_view name) {
+  baseline_frame frame = std::move(m_baseline_frames.back());
+  m_baseline_frames.pop_back();
+  if (!container || !container->is_object()) {
+    return;
+  }
+  boost::json::object &object = container->get_object();
+  auto it = object.find(name);
+  if (it == object.end()) {
+    return;
+  }
+  m_baseline_frames.back().saved.emplace_back(name.data(), name.size());
+  if (!frame.base) {
+    return;
+  }
+  boost::json::value &value = it->value();
+  if (value.is_object() && frame.base->is_object()) {
+    // Unchanged members were already dropped: what is left must be equal to the baseline.
+    boost::json::object &members = value.get_object();
+    if (delete_missing(members, frame)) {
+      return;
+    }
+    const boost::json::object &base = frame.base->get_object();
+    bool has_class_info = false;
+    for (auto const &member : members) {
+      const boost::json::value *b = base.if_contains(member.key());
+      if (!b || *b != member.value()) {
+        return;
+      }
+      const std::string_view key(member.key().data(), member.key().size());
+      has_class_info = has_class_info || key == param::ClassIdOptionalKey.name() || key == param::ClassNameKey.name() ||
+                       key == param::TrackingKey.name();
+    }
+    if (!has_class_info) {
+      object.erase(it);
+    }
+  } else if (value == *frame.base) {
+    object.erase(it);
+  }
+}
+
+bool json_oarchive::delete_missing(boost::json::object &object, const baseline_frame &frame) {
+  if (!frame.base || !frame.base->is_object()) {
+    return false;
+  }
+  bool deleted = false;
+  for (auto const &member : frame.base->get_object()) {
+    const std::string key(member.key().data(), member.key().size());
+    if (isClassInfoKey(key) || object.contains(member.key()) ||
+        std::find(frame.saved.begin(), frame.saved.end(), key) != frame.saved.end()) {
+      continue;
+    }
+    object[member.key()] = nullptr;
+    deleted = true;
+  }
+  return deleted;
+}
+
+void json_oarchive::save_override(const class_name_type &t) {
+  if (this->get_flags() & json_string_table) {
+    m_ctx.current().second->as_object()[param::ClassNameType] = m_ctx.intern(t.t);
+  } else {
+    m_ctx.current().second->as_object()[param::ClassNameType] = t.t;
+  }
+}
 
 void json_oarchive::save_override(const version_type &t) { m_ctx.current().second->as_object()[param::VersionType] = t; }
 
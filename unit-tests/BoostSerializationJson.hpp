@@ -1,6 +1,8 @@
 #include "gcout.hpp"
 #include "structs.hpp"
 // C++ Standard Library
+#include <cstdio>
+#include <fstream>
 #include <optional>
 #include <sstream>
 #include <string>
@@ -9,7 +11,22 @@
 #include <gtest/gtest.h>
 
 // // Boost Archive JSON
+#include <boost/AsyncSink.hpp>
+#include <boost/Compression.hpp>
+#include <boost/DigestSink.hpp>
+#include <boost/FileSink.hpp>
+#include <boost/JsonCbor.hpp>
+#include <boost/JsonDocument.hpp>
+#include <boost/JsonDocumentCache.hpp>
+#include <boost/JsonIndex.hpp>
+#include <boost/JsonSnapshot.hpp>
+#include <boost/MappedFile.hpp>
+#include <boost/ReadAheadSource.hpp>
+#include <boost/archive/cbor_iarchive.hpp>
+#include <boost/archive/cbor_oarchive.hpp>
 #include <boost/archive/json_iarchive.hpp>
+#include <boost/archive/json_lines_iarchive.hpp>
+#include <boost/archive/json_lines_oarchive.hpp>
 #include <boost/archive/json_oarchive.hpp>
 #include <boost/serialization/export.hpp>
 #include <boost/serialization/map.hpp>
@@ -758,3 +775,1470 @@ TEST_F(BoostSerializationJsonTest, Serialize_ObjectsSptrsWrapper) {
 }
 
 // TEST_F(BoostSerializationJsonTest, Serialize_ObjectsSptrsWrappersWithCircularReferences) { FAIL(); }
+
+TEST_F(BoostSerializationJsonTest, Serialize_KeysNeedingEscape) {
+  stdSerialize<int>("quoted \"key\"", 42);
+  stdSerialize<std::string>("back\\slash\tkey", "value with \"quotes\"\n");
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_PrettyLayout) {
+  std::stringstream ss;
+  TestStruct s{1, 2, 3, 4};
+  std::vector<int> empty;
+  {
+    boost::archive::json_oarchive oa{ss, 0, true};
+    oa << boost::make_nvp("s", s);
+    oa << boost::make_nvp("empty", empty);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+
+  std::string pretty = ss.str();
+  EXPECT_NE(pretty.find("{\n    \"TestStruct\" : \"s\",\n"), std::string::npos);
+  EXPECT_NE(pretty.find("    \"a\" : 1,\n"), std::string::npos);
+  EXPECT_NE(pretty.find("    \"empty\" : [\n\n    ]"), std::string::npos);
+  EXPECT_EQ(pretty.back(), '\n');
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_PrettyFloatFormat) {
+  // Prettified numbers follow the stream formatting, as std::ostream << d.
+  for (double d : {0.1, -2.5e-7, 1e300, 3.0}) {
+    for (std::ios_base::fmtflags flags :
+         {std::ios_base::fmtflags(), std::ios_base::fixed, std::ios_base::scientific | std::ios_base::uppercase,
+          std::ios_base::showpoint | std::ios_base::showpos}) {
+      std::stringstream ss;
+      ss.flags(flags);
+      ss.precision(12);
+      {
+        boost::archive::json_oarchive oa{ss, 0, true};
+        oa << boost::make_nvp("d", d);
+      }
+      std::ostringstream expected;
+      expected.flags(flags);
+      expected.precision(12);
+      expected << "\"d\" : " << d << "\n";
+      EXPECT_NE(ss.str().find(expected.str()), std::string::npos) << ss.str();
+    }
+  }
+}
+
+template <typename T> std::string columnarVectorSerialize(std::string name, std::vector<T> value) {
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_columnar};
+    oa << boost::make_nvp(name.c_str(), value);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+
+  std::vector<T> loaded_o;
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss};
+  ia >> boost::make_nvp(name.c_str(), loaded_o);
+
+  EXPECT_EQ(value, loaded_o);
+  return ss.str();
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ColumnarClassWithBoolsVector) {
+  std::vector<BoolsObject> vec;
+  for (int i = 0; i < 100; i++) {
+    vec.emplace_back("booboo_" + std::to_string(i), i % 2, i % 3, i % 5);
+  }
+  std::string columnar = columnarVectorSerialize<BoolsObject>("Booboo_vec", vec);
+  EXPECT_NE(columnar.find("\"columns\""), std::string::npos);
+
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa << boost::make_nvp("Booboo_vec", vec);
+  }
+  EXPECT_LT(columnar.size(), ss.str().size());
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ColumnarMemberlessClassVector) {
+  // Rows without members are not converted: columns could not keep their count.
+  std::string json = columnarVectorSerialize<EmptyObject>("empty_vec", std::vector<EmptyObject>(3));
+  EXPECT_EQ(json.find("\"columns\""), std::string::npos);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ColumnarNestedBoolsObjectsVector) {
+  columnarVectorSerialize<NestedBoolObjects>("Booboo_vector", {NestedBoolObjects(true, false, true), NestedBoolObjects(false),
+                                                               NestedBoolObjects(), NestedBoolObjects(false, false, false)});
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ColumnarStdMap_String_BoolsObject) {
+  std::stringstream ss;
+  std::map<std::string, BoolsObject> val = {{"Key_0", BoolsObject("b1", false, false, false)},
+                                            {"Key_1", BoolsObject("b2", false, false, true)}};
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_columnar};
+    oa << boost::make_nvp("string_booboo_map", val);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+
+  std::map<std::string, BoolsObject> loaded_o;
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss};
+  ia >> boost::make_nvp("string_booboo_map", loaded_o);
+  EXPECT_EQ(val, loaded_o);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_StringTableVector) {
+  std::vector<std::string> val;
+  for (int i = 0; i < 100; i++) {
+    val.push_back(i % 2 ? "millimeters" : "kilograms");
+  }
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_string_table};
+    oa << boost::make_nvp("units", val);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+  EXPECT_NE(ss.str().find("\"string_table\":[\"kilograms\",\"millimeters\"]"), std::string::npos);
+
+  std::vector<std::string> loaded_o;
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss, boost::archive::json_string_table};
+  ia >> boost::make_nvp("units", loaded_o);
+  EXPECT_EQ(val, loaded_o);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_StringTablePolymorphPtrVector) {
+  std::vector<Object *> vec = {new BoolsObject("booboo", true, false), new BoolsObject("booboo", false),
+                               new BoolsObject("booboo", true), new BoolsObject("booboo", false)};
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_string_table};
+    oa << boost::make_nvp("Booboo_vec", vec);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+
+  std::vector<Object *> loaded_o;
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss, boost::archive::json_string_table};
+  ia >> boost::make_nvp("Booboo_vec", loaded_o);
+
+  ASSERT_EQ(vec.size(), loaded_o.size());
+  for (unsigned int i = 0; i < vec.size(); i++) {
+    EXPECT_EQ(*dynamic_cast<BoolsObject *>(vec[i]), *dynamic_cast<BoolsObject *>(loaded_o[i]));
+    delete vec[i];
+    delete loaded_o[i];
+  }
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ElideDefaults) {
+  std::stringstream ss;
+  std::vector<BoolsObject> val = {BoolsObject("", false, false, false), BoolsObject("booboo", true, false, true)};
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_elide_defaults};
+    oa << boost::make_nvp("Booboo_vec", val);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+  EXPECT_EQ(ss.str().find("false"), std::string::npos);
+
+  std::vector<BoolsObject> loaded_o = {BoolsObject("x", true, true, true)};
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss, boost::archive::json_elide_defaults};
+  ia >> boost::make_nvp("Booboo_vec", loaded_o);
+  EXPECT_EQ(val, loaded_o);
+
+  std::istringstream iss_strict(ss.str().c_str());
+  boost::archive::json_iarchive ia_strict{iss_strict};
+  EXPECT_THROW(ia_strict >> boost::make_nvp("Booboo_vec", loaded_o), std::runtime_error);
+
+  // Negative zeros are kept.
+  std::stringstream zeros;
+  {
+    const int one = 1;
+    const double positive_zero = 0.0;
+    const double negative_zero = -0.0;
+    boost::archive::json_oarchive oa{zeros, boost::archive::json_elide_defaults};
+    oa << boost::make_nvp("first", one) << boost::make_nvp("zero", positive_zero)
+       << boost::make_nvp("negative", negative_zero);
+  }
+  EXPECT_EQ(zeros.str().find("\"zero\""), std::string::npos);
+  EXPECT_NE(zeros.str().find("\"negative\""), std::string::npos);
+  int first = 0;
+  double zero = 1.0;
+  double negative = 1.0;
+  boost::archive::json_iarchive ia_zeros{zeros, boost::archive::json_elide_defaults};
+  ia_zeros >> boost::make_nvp("first", first) >> boost::make_nvp("zero", zero) >> boost::make_nvp("negative", negative);
+  EXPECT_EQ(0.0, zero);
+  EXPECT_EQ(0.0, negative);
+  EXPECT_TRUE(std::signbit(negative));
+}
+
+template <typename T> void packedBoolsSerialize(std::string name, T &val, T &loaded_o) {
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_packed_bools};
+    oa << boost::make_nvp(name.c_str(), val);
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+  EXPECT_EQ(ss.str().find("true"), std::string::npos);
+
+  std::istringstream iss(ss.str().c_str());
+  boost::archive::json_iarchive ia{iss};
+  ia >> boost::make_nvp(name.c_str(), loaded_o);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_PackedBigBoolVector) {
+  for (size_t size : {0, 1, 7, 8, 63, 64, 65, 1000}) {
+    std::vector<bool> v(size);
+    std::generate(v.begin(), v.end(), []() { return (std::rand() % 2) == 0; });
+    std::vector<bool> loaded_o;
+    packedBoolsSerialize("bool_vec", v, loaded_o);
+    EXPECT_EQ(v, loaded_o);
+  }
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_PackedBoolArrays) {
+  std::array<bool, 4> arr = {true, false, true, true};
+  std::array<bool, 4> loaded_arr = {false, false, false, false};
+  packedBoolsSerialize("bool_array", arr, loaded_arr);
+  EXPECT_EQ(arr, loaded_arr);
+
+  bool val[] = {true, false, true};
+  bool loaded_o[3] = {false, true, false};
+  packedBoolsSerialize("bool_c_array", val, loaded_o);
+  EXPECT_TRUE(memcmp(val, loaded_o, sizeof(bool[3])) == 0);
+
+  std::array<bool, 77> big_arr;
+  std::generate(big_arr.begin(), big_arr.end(), []() { return (std::rand() % 2) == 0; });
+  std::array<bool, 77> loaded_big_arr = {};
+  packedBoolsSerialize("bool_big_array", big_arr, loaded_big_arr);
+  EXPECT_EQ(big_arr, loaded_big_arr);
+}
+
+template <typename T> void parallelVectorSerialize(std::string name, std::vector<T> &value, unsigned int flags = 0) {
+  std::stringstream sequential;
+  {
+    boost::archive::json_oarchive oa{sequential, flags};
+    oa << boost::make_nvp(name.c_str(), value);
+  }
+  std::stringstream parallel;
+  {
+    boost::archive::json_oarchive oa{parallel, flags | boost::archive::json_parallel};
+    oa.set_parallel_threshold(2);
+    oa << boost::make_nvp(name.c_str(), value);
+  }
+  EXPECT_EQ(sequential.str(), parallel.str());
+
+  std::vector<T> loaded_o;
+  {
+    std::stringstream is(parallel.str());
+    boost::archive::json_iarchive ia{is, flags};
+    ia >> boost::make_nvp(name.c_str(), loaded_o);
+  }
+  EXPECT_EQ(value, loaded_o);
+
+  std::vector<T> loaded_p;
+  {
+    std::stringstream is(parallel.str());
+    boost::archive::json_iarchive ia{is, flags | boost::archive::json_parallel};
+    ia.set_parallel_threshold(2);
+    ia >> boost::make_nvp(name.c_str(), loaded_p);
+  }
+  EXPECT_EQ(value, loaded_p);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ParallelStructVector) {
+  std::vector<TestStruct> vec(10000);
+  for (int i = 0; i < static_cast<int>(vec.size()); i++) {
+    vec[i] = TestStruct{i, -i, i * 2, i % 7};
+  }
+  parallelVectorSerialize("struct_vec", vec);
+  parallelVectorSerialize("struct_vec", vec, boost::archive::json_columnar | boost::archive::json_elide_defaults);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ParallelTrackedObjectsVector) {
+  std::vector<BoolsObject> vec;
+  for (int i = 0; i < 1000; i++) {
+    vec.emplace_back("booboo_" + std::to_string(i), i % 2, i % 3, i % 5);
+  }
+  parallelVectorSerialize("Booboo_vec", vec);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_ParallelMetadataDetection) {
+  // User members named like metadata keys are not class information.
+  EXPECT_FALSE(JsonContext::hasMetadata(boost::json::parse(R"([{"version":3,"tracking":true,"a":1}])")));
+  EXPECT_FALSE(JsonContext::hasTracking(boost::json::parse(R"([{"version":3,"tracking":true,"a":1}])")));
+
+  boost::json::value info = boost::json::parse(R"({"class_id_opt":0,"tracking":false,"version":0,"a":1})");
+  EXPECT_TRUE(JsonContext::hasMetadata(info));
+  EXPECT_FALSE(JsonContext::hasTracking(info));
+  info.get_object()["tracking"] = true;
+  EXPECT_TRUE(JsonContext::hasTracking(info));
+  EXPECT_TRUE(JsonContext::hasTracking(boost::json::parse(R"({"a":{"object_id_ref":2}})")));
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_JsonLines) {
+  std::stringstream ss;
+  {
+    boost::archive::json_lines_oarchive oa{ss};
+    for (int i = 0; i < 3; i++) {
+      TestStruct record{i, i + 1, i + 2, i + 3};
+      oa << boost::make_nvp("record", record);
+    }
+    std::string text = "last";
+    oa << boost::make_nvp("text", text);
+    oa.flush();
+  }
+  GTEST_COUT << ss.str() << GTEST_ENDL;
+
+  std::string line;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(std::getline(ss, line));
+    EXPECT_EQ(line.find('\n'), std::string::npos);
+    std::stringstream is(line);
+    boost::archive::json_iarchive ia{is};
+    TestStruct loaded_o;
+    ia >> boost::make_nvp("record", loaded_o);
+    EXPECT_EQ(loaded_o, (TestStruct{i, i + 1, i + 2, i + 3}));
+  }
+  ASSERT_TRUE(std::getline(ss, line));
+  EXPECT_EQ(line, "{\"text\":\"last\"}");
+  EXPECT_FALSE(std::getline(ss, line));
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_JsonLinesPost) {
+  std::stringstream ss;
+  boost::archive::json_lines_oarchive oa{ss};
+  for (int i = 0; i < 500; i++) {
+    oa.post("record", testStruct(i));
+  }
+  oa.flush();
+
+  std::string line;
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(std::getline(ss, line));
+    std::stringstream is(line);
+    boost::archive::json_iarchive ia{is};
+    TestStruct loaded_o;
+    ia >> boost::make_nvp("record", loaded_o);
+    EXPECT_EQ(loaded_o, testStruct(i));
+  }
+  EXPECT_FALSE(std::getline(ss, line));
+
+  // Flushed while records are started from another thread.
+  std::stringstream concurrent;
+  boost::archive::json_lines_oarchive oa_concurrent{concurrent};
+  auto flushes = std::async(std::launch::async, [&oa_concurrent]() {
+    for (int i = 0; i < 50; i++) {
+      oa_concurrent.flush();
+    }
+  });
+  for (int i = 0; i < 500; i++) {
+    oa_concurrent.post("record", testStruct(i));
+  }
+  flushes.get();
+  oa_concurrent.flush();
+  const std::string text = concurrent.str();
+  EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 500);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_JsonLines) {
+  const int records = 5000;
+  std::stringstream ss;
+  {
+    boost::archive::json_lines_oarchive oa{ss};
+    for (int i = 0; i < records; i++) {
+      TestStruct record = testStruct(i);
+      oa << boost::make_nvp("record", record);
+    }
+  }
+  const std::string text = ss.str() + "\r\n\n";
+
+  {
+    std::stringstream is(text);
+    boost::archive::json_lines_iarchive ia{is};
+    TestStruct loaded_o;
+    for (int i = 0; i < records; i++) {
+      ia >> boost::make_nvp("record", loaded_o);
+      EXPECT_EQ(loaded_o, testStruct(i));
+    }
+    EXPECT_FALSE(ia.next(boost::make_nvp("record", loaded_o)));
+    ASSERT_THROW(ia >> boost::make_nvp("record", loaded_o), std::runtime_error);
+  }
+
+  {
+    std::stringstream is(text);
+    boost::archive::json_lines_iarchive ia{is};
+    int i = 0;
+    size_t count = ia.for_each<TestStruct>(
+        "record",
+        [&i](TestStruct &&loaded_o) {
+          EXPECT_EQ(loaded_o, testStruct(i));
+          i++;
+        },
+        16);
+    EXPECT_EQ(count, static_cast<size_t>(records));
+    EXPECT_EQ(i, records);
+  }
+
+  {
+    // A throwing callback leaves batches queued on the pool: they are drained before for_each returns.
+    std::stringstream is(text);
+    boost::archive::json_lines_iarchive ia{is};
+    ASSERT_THROW(ia.for_each<TestStruct>(
+                     "record", [](TestStruct &&) { throw std::runtime_error("callback"); }, 1),
+                 std::runtime_error);
+  }
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_JsonLinesThrowOnBadRecord) {
+  std::stringstream is("{\"record\":1}\n{\"record\":\n");
+  boost::archive::json_lines_iarchive ia{is};
+  int loaded_o = 0;
+  ia >> boost::make_nvp("record", loaded_o);
+  EXPECT_EQ(loaded_o, 1);
+  ASSERT_THROW(ia >> boost::make_nvp("record", loaded_o), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_FlushThresholdAfterError) {
+  std::stringstream ss;
+  boost::archive::json_oarchive oa{ss};
+  oa.set_flush_threshold(1);
+  std::string str = "value";
+  oa << boost::make_nvp("str", str);
+  FailingStruct failing{-1};
+  ASSERT_THROW(oa << boost::make_nvp("failing", failing), std::runtime_error);
+
+  // Members saved after the error are still written as soon as they are complete.
+  const size_t written = ss.str().size();
+  std::vector<int> ints(10, 7);
+  oa << boost::make_nvp("ints", ints);
+  EXPECT_NE(ss.str().find("\"ints\":[7,7,7", written), std::string::npos);
+}
+
+void flushedSave(boost::archive::json_oarchive &oa) {
+  std::vector<TestStruct> vec = testStructs(100);
+  std::string str = "value";
+  double d = 0.5;
+  TestStruct t{1, 2, 3, 4};
+  oa << boost::make_nvp("vec", vec);
+  oa.flush();
+  oa << boost::make_nvp("str", str);
+  oa << boost::make_nvp("d", d);
+  oa << boost::make_nvp("t", t);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_FlushThreshold) {
+  for (bool prettify : {false, true}) {
+    std::stringstream whole;
+    {
+      boost::archive::json_oarchive oa{whole, 0, prettify};
+      std::vector<TestStruct> vec = testStructs(100);
+      std::string str = "value";
+      double d = 0.5;
+      TestStruct t{1, 2, 3, 4};
+      oa << boost::make_nvp("vec", vec) << boost::make_nvp("str", str) << boost::make_nvp("d", d)
+         << boost::make_nvp("t", t);
+    }
+    for (size_t threshold : {0, 64}) {
+      std::stringstream chunked;
+      boost::archive::json_oarchive oa{chunked, 0, prettify};
+      oa.set_flush_threshold(threshold);
+      flushedSave(oa);
+      EXPECT_FALSE(chunked.str().empty());
+      oa.finish();
+      EXPECT_EQ(chunked.str(), whole.str());
+    }
+  }
+
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa.set_flush_threshold(64);
+    flushedSave(oa);
+  }
+  boost::archive::json_iarchive ia{ss};
+  std::vector<TestStruct> vec;
+  std::string str;
+  double d = 0;
+  TestStruct t;
+  ia >> boost::make_nvp("vec", vec) >> boost::make_nvp("str", str) >> boost::make_nvp("d", d) >> boost::make_nvp("t", t);
+  ASSERT_EQ(vec.size(), 100u);
+  EXPECT_EQ(vec[99], (TestStruct{99, -99, 198, 0}));
+  EXPECT_EQ(str, "value");
+  EXPECT_EQ(d, 0.5);
+  EXPECT_EQ(t, (TestStruct{1, 2, 3, 4}));
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_FinishThrowOnStreamFailure) {
+  std::stringstream ss;
+  boost::archive::json_oarchive oa{ss};
+  int i = 1;
+  oa << boost::make_nvp("int", i);
+  ss.setstate(std::ios::badbit);
+  ASSERT_THROW(oa.finish(), std::runtime_error);
+}
+
+class FailingSink : public JsonSink {
+public:
+  void write(std::string &) override { throw std::runtime_error("Sink failure !"); }
+  void flush() override {}
+};
+
+TEST_F(BoostSerializationJsonTest, Serialize_AsyncSink) {
+  std::vector<TestStruct> vec = testStructs(10000);
+  std::string text = "text";
+  std::stringstream expected;
+  {
+    boost::archive::json_oarchive oa{expected, 0, true};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("text", text);
+  }
+
+  std::stringstream ss;
+  {
+    OStreamSink target{ss};
+    AsyncSink sink{target, 2};
+    boost::archive::json_oarchive oa{sink, 0, true};
+    oa.set_flush_threshold(1024);
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("text", text);
+    oa.finish();
+  }
+  EXPECT_EQ(ss.str(), expected.str());
+
+  FailingSink failing;
+  AsyncSink sink{failing};
+  boost::archive::json_oarchive oa{sink};
+  oa << boost::make_nvp("vec", vec);
+  ASSERT_THROW(oa.finish(), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_Source) {
+  std::vector<TestStruct> vec = testStructs(10000);
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa << boost::make_nvp("vec", vec);
+  }
+  IStreamSource source{ss};
+  ReadAheadSource read_ahead{source, 2, 1000};
+  boost::archive::json_iarchive ia{read_ahead};
+  std::vector<TestStruct> loaded_o;
+  ia >> boost::make_nvp("vec", loaded_o);
+  EXPECT_EQ(vec, loaded_o);
+}
+
+template <typename Sink, typename Source> void compressedSerialize() {
+  std::vector<TestStruct> vec = testStructs(10000);
+  std::string text = "text";
+  std::stringstream plain;
+  {
+    boost::archive::json_oarchive oa{plain};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("text", text);
+  }
+
+  std::stringstream ss;
+  {
+    OStreamSink target{ss};
+    Sink sink{target};
+    boost::archive::json_oarchive oa{sink};
+    oa.set_flush_threshold(4096);
+    oa << boost::make_nvp("vec", vec);
+    oa.flush();
+    oa << boost::make_nvp("text", text);
+  }
+  GTEST_COUT << "Compressed " << plain.str().size() << " -> " << ss.str().size() << " bytes" << GTEST_ENDL;
+  EXPECT_LT(ss.str().size(), plain.str().size());
+
+  for (bool read_ahead : {false, true}) {
+    std::stringstream is(ss.str());
+    IStreamSource source{is};
+    Source decompressed{source};
+    {
+      std::unique_ptr<ReadAheadSource> ahead = read_ahead ? std::make_unique<ReadAheadSource>(decompressed) : nullptr;
+      JsonSource &input = ahead ? static_cast<JsonSource &>(*ahead) : decompressed;
+      boost::archive::json_iarchive ia{input};
+      std::vector<TestStruct> loaded_o;
+      std::string loaded_text;
+      ia >> boost::make_nvp("vec", loaded_o) >> boost::make_nvp("text", loaded_text);
+      EXPECT_EQ(vec, loaded_o);
+      EXPECT_EQ(text, loaded_text);
+    }
+  }
+
+  std::stringstream truncated(ss.str().substr(0, ss.str().size() / 2));
+  IStreamSource source{truncated};
+  Source decompressed{source};
+  ASSERT_THROW(boost::archive::json_iarchive ia{decompressed}, std::runtime_error);
+}
+
+#ifdef BOOST_JSON_ARCHIVE_ZLIB
+TEST_F(BoostSerializationJsonTest, Serialize_Gzip) { compressedSerialize<GzipSink, GzipSource>(); }
+#endif
+
+#ifdef BOOST_JSON_ARCHIVE_ZSTD
+TEST_F(BoostSerializationJsonTest, Serialize_Zstd) { compressedSerialize<ZstdSink, ZstdSource>(); }
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(BoostSerializationJsonTest, Serialize_FileSink) {
+  std::vector<TestStruct> vec = testStructs(10000);
+  std::stringstream expected;
+  {
+    boost::archive::json_oarchive oa{expected, 0, true};
+    oa << boost::make_nvp("vec", vec);
+  }
+
+  const std::string path = "FileSink.json";
+  for (bool direct : {false, true}) {
+    for (size_t buffer_size : {size_t(1000), FileSink::DefaultBufferSize}) {
+      {
+        FileSink sink{path, expected.str().size(), direct, buffer_size};
+        boost::archive::json_oarchive oa{sink, 0, true};
+        oa.set_flush_threshold(512);
+        oa << boost::make_nvp("vec", vec);
+        oa.finish();
+      }
+      std::ifstream is{path, std::ios::binary};
+      std::string written{std::istreambuf_iterator<char>(is), {}};
+      EXPECT_EQ(written, expected.str());
+    }
+  }
+  std::remove(path.c_str());
+
+  ASSERT_THROW(FileSink sink{"missing_directory/FileSink.json"}, std::runtime_error);
+}
+#endif
+
+TEST_F(BoostSerializationJsonTest, Serialize_Measure) {
+  std::vector<TestStruct> vec{{1, -2, 3, 4}, {-100000, 0, 7, 123456789}};
+  std::vector<double> doubles{0.0, -1.5, 3.141592653589793, 1e-300, 2.5e20};
+  std::string text = "Quote \" backslash \\ tab \t newline \n unicode \xc3\xa9 control \x01";
+  std::vector<std::string> empty;
+  ObjectWithStruct nested{TestStruct({5, 6, 7, 8})};
+
+  for (bool prettify : {false, true}) {
+    std::string out;
+    StringSink sink{out};
+    boost::archive::json_oarchive oa{sink, 0, prettify};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("text", text)
+       << boost::make_nvp("empty", empty) << boost::make_nvp("nested", nested);
+    const size_t size = oa.measure();
+    out.reserve(size);
+    const char *data = out.data();
+    oa.finish();
+    EXPECT_EQ(size, out.size());
+    EXPECT_EQ(data, out.data());
+
+    std::stringstream ss;
+    {
+      boost::archive::json_oarchive oa2{ss, 0, prettify};
+      oa2 << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("text", text)
+          << boost::make_nvp("empty", empty) << boost::make_nvp("nested", nested);
+    }
+    EXPECT_EQ(ss.str(), out);
+
+    std::vector<char> memory(size);
+    MemorySink exact{memory.data(), memory.size()};
+    {
+      boost::archive::json_oarchive oa3{exact, 0, prettify};
+      oa3 << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("text", text)
+          << boost::make_nvp("empty", empty) << boost::make_nvp("nested", nested);
+      oa3.finish();
+    }
+    EXPECT_EQ(std::string(memory.data(), exact.size()), out);
+
+    MemorySink small{memory.data(), 16};
+    boost::archive::json_oarchive oa4{small, 0, prettify};
+    oa4 << boost::make_nvp("vec", vec);
+    ASSERT_THROW(oa4.finish(), std::runtime_error);
+  }
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_SharedDocument) {
+  std::vector<TestStruct> vec = testStructs(1000);
+  std::string text = "network";
+  ObjectWithStruct object{TestStruct({5, 6, 7, 8})};
+  std::stringstream network;
+  {
+    boost::archive::json_oarchive oa{network, boost::archive::json_string_table};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("text", text);
+  }
+  std::stringstream storage;
+  {
+    boost::archive::json_oarchive oa{storage};
+    oa << boost::make_nvp("object", object);
+  }
+  std::stringstream ss("{\"network\":" + network.str() + ",\"storage\":" + storage.str() + "}");
+  auto document = JsonDocument::parse(ss);
+
+  std::vector<std::future<bool>> loads;
+  for (int i = 0; i < 8; i++) {
+    loads.push_back(std::async(std::launch::async, [&, i]() {
+      if (i % 2) {
+        boost::archive::json_iarchive ia{document, "/storage"};
+        ObjectWithStruct loaded_object;
+        ia >> boost::make_nvp("object", loaded_object);
+        return loaded_object == object;
+      }
+      boost::archive::json_iarchive ia{document, "/network", boost::archive::json_string_table};
+      std::vector<TestStruct> loaded_vec;
+      std::string loaded_text;
+      ia >> boost::make_nvp("vec", loaded_vec) >> boost::make_nvp("text", loaded_text);
+      return loaded_vec == vec && loaded_text == text;
+    }));
+  }
+  for (auto &load : loads) {
+    EXPECT_TRUE(load.get());
+  }
+
+  boost::archive::json_iarchive ia{document, "/network/vec"};
+  std::vector<TestStruct> loaded_vec;
+  ia >> boost::make_nvp("vec", loaded_vec);
+  EXPECT_EQ(vec, loaded_vec);
+
+  ASSERT_THROW(boost::archive::json_iarchive(document, "/missing"), std::runtime_error);
+}
+
+/**
+ * @brief JsonSource returning a few bytes at a time.
+ */
+class TrickleSource : public JsonSource {
+public:
+  explicit TrickleSource(const std::string &data) : m_data{data} {}
+
+  size_t read(char *data, size_t size) override {
+    size_t n = std::min({size, size_t(7), m_data.size() - m_pos});
+    std::copy_n(m_data.data() + m_pos, n, data);
+    m_pos += n;
+    return n;
+  }
+
+private:
+  std::string m_data;
+  size_t m_pos = 0;
+};
+
+TEST_F(BoostSerializationJsonTest, Deserialize_Pointer) {
+  int version = 7;
+  std::vector<TestStruct> vec = testStructs(1000);
+  std::vector<int> ints{10, 20, 30, 40};
+  std::string text = "Quoted \"text\" with {braces} and [brackets]";
+  ObjectWithUIntList object{{5, 6, 7}};
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss, boost::archive::json_string_table};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("text", text) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("object", object) << boost::make_nvp("version", version);
+  }
+
+  {
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is, "/version", boost::archive::json_string_table};
+    int loaded_version = 0;
+    ia >> boost::make_nvp("version", loaded_version);
+    EXPECT_EQ(version, loaded_version);
+  }
+  {
+    TrickleSource source{ss.str()};
+    boost::archive::json_iarchive ia{source, "/text", boost::archive::json_string_table};
+    std::string loaded_text;
+    ia >> boost::make_nvp("text", loaded_text);
+    EXPECT_EQ(text, loaded_text);
+  }
+  {
+    TrickleSource source{ss.str()};
+    boost::archive::json_iarchive ia{source, "/object", boost::archive::json_string_table};
+    ObjectWithUIntList loaded_object;
+    ia >> boost::make_nvp("object", loaded_object);
+    EXPECT_EQ(object, loaded_object);
+  }
+  {
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is, "/ints/2", boost::archive::json_string_table};
+    int loaded_int = 0;
+    ia >> boost::make_nvp("2", loaded_int);
+    EXPECT_EQ(ints[2], loaded_int);
+  }
+  {
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is, "/vec", boost::archive::json_string_table};
+    std::vector<TestStruct> loaded_vec;
+    ia >> boost::make_nvp("vec", loaded_vec);
+    EXPECT_EQ(vec, loaded_vec);
+  }
+
+  std::stringstream missing(ss.str());
+  ASSERT_THROW(boost::archive::json_iarchive(missing, "/ints/4"), std::runtime_error);
+  std::stringstream invalid(ss.str());
+  ASSERT_THROW(boost::archive::json_iarchive(invalid, "ints"), std::runtime_error);
+  std::stringstream truncated(ss.str().substr(0, ss.str().size() / 2));
+  ASSERT_THROW(boost::archive::json_iarchive(truncated, "/version"), std::runtime_error);
+
+  // Escaped keys along the pointer: surrogate pairs are decoded, broken ones are rejected.
+  {
+    std::stringstream is(R"({"\ud83d\ude00":{"a\/b":5}})");
+    boost::archive::json_iarchive ia{is, "/\xF0\x9F\x98\x80/a~1b"};
+    int loaded_int = 0;
+    ia >> boost::make_nvp("a/b", loaded_int);
+    EXPECT_EQ(5, loaded_int);
+  }
+  for (const char *text : {R"({"\ud83d\u0041":1,"a":2})", R"({"\ude00":1,"a":2})", R"({"\q":1,"a":2})"}) {
+    std::stringstream is(text);
+    ASSERT_THROW(boost::archive::json_iarchive(is, "/a"), std::runtime_error);
+  }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(BoostSerializationJsonTest, Deserialize_Index) {
+  std::vector<NestedBoolObjects> vec;
+  for (int i = 0; i < 1000; i++) {
+    vec.emplace_back(i % 2, i % 3, i % 5);
+  }
+  std::vector<std::string> names;
+  for (int i = 0; i < 100; i++) {
+    names.push_back("name_" + std::to_string(i % 10));
+  }
+
+  const std::string path = "Index.json";
+  for (bool prettify : {false, true}) {
+    for (size_t stride : {size_t(1), size_t(7)}) {
+      JsonIndex index{stride};
+      {
+        std::ofstream os{path, std::ios::binary};
+        boost::archive::json_oarchive oa{os, boost::archive::json_string_table, prettify};
+        oa.set_index(index);
+        oa.set_flush_threshold(prettify ? 4096 : 0);
+        oa << boost::make_nvp("vec", vec) << boost::make_nvp("names", names);
+      }
+      std::stringstream saved;
+      index.save(saved);
+      JsonIndex loaded = JsonIndex::load(saved);
+      ASSERT_EQ(stride, loaded.stride());
+      ASSERT_NE(nullptr, loaded.find("vec"));
+      EXPECT_EQ(vec.size(), loaded.find("vec")->size);
+
+      MappedFile file{path};
+      for (auto [first, count] : {std::pair<size_t, size_t>{0, 1}, {1, 1}, {6, 3}, {500, 10}, {993, 7}, {0, 1000}}) {
+        boost::archive::json_iarchive ia{file.data(), loaded, "vec", first, count, boost::archive::json_string_table};
+        std::vector<NestedBoolObjects> loaded_vec;
+        ia >> boost::make_nvp("vec", loaded_vec);
+        EXPECT_EQ(std::vector<NestedBoolObjects>(vec.begin() + first, vec.begin() + first + count), loaded_vec);
+      }
+      boost::archive::json_iarchive ia{file.data(), loaded, "names", 42, 3, boost::archive::json_string_table};
+      std::vector<std::string> loaded_names;
+      ia >> boost::make_nvp("names", loaded_names);
+      EXPECT_EQ(std::vector<std::string>(names.begin() + 42, names.begin() + 45), loaded_names);
+
+      ASSERT_THROW(boost::archive::json_iarchive(file.data(), loaded, "vec", 999, 2), std::runtime_error);
+      ASSERT_THROW(boost::archive::json_iarchive(file.data(), loaded, "missing", 0, 1), std::runtime_error);
+    }
+  }
+  std::remove(path.c_str());
+}
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(BoostSerializationJsonTest, Deserialize_IndexClassInformation) {
+  // TestStruct class information is written with lists[2] only, loaded beforehand by ranges after it.
+  std::vector<TestStructList> lists(6);
+  lists[2].list = testStructs(2);
+  lists[3].list = testStructs(3);
+  lists[5].list = testStructs(1);
+  std::vector<std::shared_ptr<Object>> ptrs{std::make_shared<Object>(), nullptr};
+
+  const std::string path = "Index.json";
+  JsonIndex index{1};
+  {
+    std::ofstream os{path, std::ios::binary};
+    boost::archive::json_oarchive oa{os};
+    oa.set_index(index);
+    oa << boost::make_nvp("lists", lists) << boost::make_nvp("ptrs", ptrs);
+  }
+  MappedFile file{path};
+  for (auto [first, count] : {std::pair<size_t, size_t>{3, 1}, {0, 6}, {1, 2}, {4, 2}, {5, 1}}) {
+    boost::archive::json_iarchive ia{file.data(), index, "lists", first, count};
+    std::vector<TestStructList> loaded;
+    ia >> boost::make_nvp("lists", loaded);
+    EXPECT_EQ(std::vector<TestStructList>(lists.begin() + first, lists.begin() + first + count), loaded);
+  }
+  ASSERT_THROW(boost::archive::json_iarchive(file.data(), index, "ptrs", 0, 1), std::runtime_error);
+  std::remove(path.c_str());
+}
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST_F(BoostSerializationJsonTest, Serialize_Snapshot) {
+  std::vector<NestedBoolObjects> vec;
+  for (int i = 0; i < 100; i++) {
+    vec.emplace_back(i % 2, i % 3, i % 5);
+  }
+  std::vector<double> doubles{0.1, -2.5e-300, 1e300};
+  std::vector<uint64_t> big{0, uint64_t(1) << 63, ~uint64_t(0)};
+  std::string text = "Unicode \xc3\xa9 and \"quotes\"";
+
+  std::stringstream json;
+  std::string alongside;
+  {
+    boost::archive::json_oarchive oa{json, boost::archive::json_string_table};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("big", big)
+       << boost::make_nvp("text", text);
+    StringSink sink{alongside};
+    oa.write_snapshot(sink);
+  }
+  std::stringstream snapshot;
+  {
+    boost::archive::json_oarchive oa{snapshot, boost::archive::json_string_table | boost::archive::json_snapshot};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("big", big)
+       << boost::make_nvp("text", text);
+    EXPECT_EQ(alongside.size(), oa.measure());
+  }
+  EXPECT_EQ(alongside, snapshot.str());
+  EXPECT_TRUE(JsonSnapshot::isSnapshot(snapshot.str()));
+  EXPECT_EQ(boost::json::parse(json.str()), JsonSnapshot::decode(snapshot.str()));
+
+  auto check = [&](boost::archive::json_iarchive &ia) {
+    std::vector<NestedBoolObjects> loaded_vec;
+    std::vector<double> loaded_doubles;
+    std::vector<uint64_t> loaded_big;
+    std::string loaded_text;
+    ia >> boost::make_nvp("vec", loaded_vec) >> boost::make_nvp("doubles", loaded_doubles) >>
+        boost::make_nvp("big", loaded_big) >> boost::make_nvp("text", loaded_text);
+    EXPECT_EQ(vec, loaded_vec);
+    EXPECT_EQ(doubles, loaded_doubles);
+    EXPECT_EQ(big, loaded_big);
+    EXPECT_EQ(text, loaded_text);
+  };
+  {
+    std::stringstream is(snapshot.str());
+    boost::archive::json_iarchive ia{is, boost::archive::json_string_table};
+    check(ia);
+  }
+  {
+    TrickleSource source{snapshot.str()};
+    boost::archive::json_iarchive ia{source, boost::archive::json_string_table};
+    check(ia);
+  }
+  const std::string path = "Snapshot.bin";
+  {
+    std::ofstream os{path, std::ios::binary};
+    os << snapshot.str();
+  }
+  {
+    MappedFile file{path};
+    boost::archive::json_iarchive ia{file.data(), boost::archive::json_string_table};
+    check(ia);
+  }
+  std::remove(path.c_str());
+
+  ASSERT_THROW(JsonSnapshot::decode(snapshot.str().substr(0, snapshot.str().size() - 1)), std::runtime_error);
+  std::string corrupted = snapshot.str();
+  corrupted[JsonSnapshot::HeaderSize] = 42;
+  ASSERT_THROW(JsonSnapshot::decode(corrupted), std::runtime_error);
+  {
+    // Parsing reports invalid snapshots in the error code, as invalid Json texts.
+    boost::system::error_code ec;
+    std::stringstream is(corrupted);
+    EXPECT_NO_THROW(JsonContext::parse(is, ec));
+    EXPECT_TRUE(ec);
+    ec = {};
+    TrickleSource source{corrupted};
+    EXPECT_NO_THROW(JsonContext::parse(source, ec));
+    EXPECT_TRUE(ec);
+    TrickleSource truncated{snapshot.str().substr(0, snapshot.str().size() - 1)};
+    ASSERT_THROW(boost::archive::json_iarchive(truncated, boost::archive::json_string_table), std::runtime_error);
+  }
+
+  // [null,null]: array header (9 bytes), 2 slots, then the 2 nodes. Both slots pointing to the first node (shared
+  // nodes could expand exponentially) is rejected.
+  std::string shared = JsonSnapshot::encode(boost::json::parse("[null,null]"));
+  const size_t slots = JsonSnapshot::HeaderSize + 9;
+  EXPECT_EQ(boost::json::parse("[null,null]"), JsonSnapshot::decode(shared));
+  std::copy(shared.begin() + slots, shared.begin() + slots + 8, shared.begin() + slots + 8);
+  ASSERT_THROW(JsonSnapshot::decode(shared), std::runtime_error);
+}
+#endif
+
+TEST_F(BoostSerializationJsonTest, Serialize_Cbor) {
+  // RFC 8949 examples.
+  EXPECT_EQ(std::string("\xa2\x61\x61\x01\x61\x62\x82\x02\x03", 9), JsonCbor::encode(boost::json::parse("{\"a\":1,\"b\":[2,3]}")));
+  EXPECT_EQ(std::string("\x3b\x7f\xff\xff\xff\xff\xff\xff\xff", 9), JsonCbor::encode(boost::json::value(INT64_MIN)));
+  EXPECT_EQ(std::string("\xfa\x47\xc3\x50\x00", 5), JsonCbor::encode(boost::json::value(100000.0)));
+  EXPECT_EQ(boost::json::value(-4.0), JsonCbor::decode(std::string("\xf9\xc4\x00", 3)));
+  EXPECT_EQ(boost::json::parse("[\"streaming\",[1,2]]"),
+            JsonCbor::decode(std::string("\x82\x7f\x65strea\x64ming\xff\x9f\x01\x02\xff", 18)));
+
+  std::vector<NestedBoolObjects> vec;
+  for (int i = 0; i < 100; i++) {
+    vec.emplace_back(i % 2, i % 3, i % 5);
+  }
+  std::vector<double> doubles{0.5, 0.1, -2.5e-300, 1e300};
+  std::vector<int64_t> ints{0, -1, 23, 24, -25, 1000000, INT64_MIN, INT64_MAX};
+  std::string text = "Unicode \xc3\xa9 and \"quotes\"";
+
+  std::stringstream json;
+  {
+    boost::archive::json_oarchive oa{json};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("text", text);
+  }
+  std::stringstream cbor;
+  {
+    boost::archive::cbor_oarchive oa{cbor};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("doubles", doubles) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("text", text);
+    EXPECT_EQ(oa.measure(), JsonCbor::encode(boost::json::parse(json.str())).size());
+  }
+  GTEST_COUT << "Json " << json.str().size() << " bytes, CBOR " << cbor.str().size() << " bytes" << GTEST_ENDL;
+  EXPECT_LT(cbor.str().size(), json.str().size());
+  EXPECT_EQ(boost::json::parse(json.str()), JsonCbor::decode(cbor.str()));
+
+  auto check = [&](boost::archive::json_iarchive &ia) {
+    std::vector<NestedBoolObjects> loaded_vec;
+    std::vector<double> loaded_doubles;
+    std::vector<int64_t> loaded_ints;
+    std::string loaded_text;
+    ia >> boost::make_nvp("vec", loaded_vec) >> boost::make_nvp("doubles", loaded_doubles) >>
+        boost::make_nvp("ints", loaded_ints) >> boost::make_nvp("text", loaded_text);
+    EXPECT_EQ(vec, loaded_vec);
+    EXPECT_EQ(doubles, loaded_doubles);
+    EXPECT_EQ(ints, loaded_ints);
+    EXPECT_EQ(text, loaded_text);
+  };
+  {
+    std::stringstream is(cbor.str());
+    boost::archive::cbor_iarchive ia{is};
+    check(ia);
+  }
+  {
+    TrickleSource source{cbor.str()};
+    boost::archive::cbor_iarchive ia{source};
+    check(ia);
+  }
+
+  ASSERT_THROW(boost::archive::cbor_iarchive(std::string_view(cbor.str()).substr(0, cbor.str().size() - 1)),
+               std::runtime_error);
+  ASSERT_THROW(boost::archive::cbor_iarchive(std::string_view(json.str())), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_DocumentCache) {
+  std::vector<TestStruct> vec = testStructs(100);
+  auto save = [&vec](const std::string &path, size_t size) {
+    std::ofstream os{path, std::ios::binary};
+    boost::archive::json_oarchive oa{os};
+    std::vector<TestStruct> part(vec.begin(), vec.begin() + size);
+    oa << boost::make_nvp("vec", part);
+  };
+  const std::string first = "Cache1.json";
+  const std::string second = "Cache2.json";
+  save(first, 100);
+  save(second, 50);
+
+  JsonDocumentCache cache;
+  auto document = cache.load(first);
+  EXPECT_EQ(document, cache.load(first));
+  EXPECT_EQ(1u, cache.count());
+  EXPECT_EQ(JsonDocumentCache::footprint(document->root()), cache.size());
+
+  std::vector<std::future<std::shared_ptr<const JsonDocument>>> loads;
+  for (int i = 0; i < 4; i++) {
+    loads.push_back(std::async(std::launch::async, [&cache, &second]() { return cache.load(second); }));
+  }
+  auto shared = loads[0].get();
+  for (size_t i = 1; i < loads.size(); i++) {
+    EXPECT_EQ(shared, loads[i].get());
+  }
+  {
+    boost::archive::json_iarchive ia{shared};
+    std::vector<TestStruct> loaded;
+    ia >> boost::make_nvp("vec", loaded);
+    EXPECT_EQ(std::vector<TestStruct>(vec.begin(), vec.begin() + 50), loaded);
+  }
+
+  // Changed file: parsed again.
+  save(second, 60);
+  auto changed = cache.load(second);
+  EXPECT_NE(shared, changed);
+  {
+    boost::archive::json_iarchive ia{changed};
+    std::vector<TestStruct> loaded;
+    ia >> boost::make_nvp("vec", loaded);
+    EXPECT_EQ(std::vector<TestStruct>(vec.begin(), vec.begin() + 60), loaded);
+  }
+  EXPECT_EQ(2u, cache.count());
+
+  // Least recently used first evicted.
+  cache.load(first);
+  cache.setBudget(JsonDocumentCache::footprint(document->root()));
+  EXPECT_EQ(1u, cache.count());
+  EXPECT_EQ(document, cache.load(first));
+  cache.clear();
+  EXPECT_EQ(0u, cache.count());
+  EXPECT_EQ(0u, cache.size());
+
+  std::remove(first.c_str());
+  std::remove(second.c_str());
+  ASSERT_THROW(cache.load(first), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_Canonical) {
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, DigestSink::digest("", 0));
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, DigestSink::digest("abc", 3));
+
+  TestStruct ts{1, 2, 3, 4};
+  std::vector<double> doubles{2.5, -0.0, 0.1};
+  std::string text = "canonical";
+  std::vector<NestedBoolObjects> vec;
+  for (int i = 0; i < 100; i++) {
+    vec.emplace_back(i % 2, i % 3, i % 5);
+  }
+
+  // Members saved in another order (class ids follow the save order), prettify ignored: identical bytes.
+  std::stringstream first;
+  {
+    boost::archive::json_oarchive oa{first, boost::archive::json_canonical};
+    oa << boost::make_nvp("text", text) << boost::make_nvp("doubles", doubles) << boost::make_nvp("ts", ts)
+       << boost::make_nvp("vec", vec);
+  }
+  std::stringstream second;
+  {
+    boost::archive::json_oarchive oa{second, boost::archive::json_canonical, true};
+    oa << boost::make_nvp("doubles", doubles) << boost::make_nvp("ts", ts) << boost::make_nvp("text", text)
+       << boost::make_nvp("vec", vec);
+  }
+  EXPECT_EQ(first.str(), second.str());
+  EXPECT_EQ(std::string::npos, first.str().find_first_of(" \n"));
+  EXPECT_EQ(std::string::npos, first.str().find("-0"));
+  EXPECT_EQ(0u, first.str().find("{\"doubles\":"));
+
+  // Digest only: nothing is produced, same digest as the written bytes.
+  DigestSink digestOnly;
+  uint64_t measured = 0;
+  {
+    boost::archive::json_oarchive oa{digestOnly, boost::archive::json_canonical};
+    oa << boost::make_nvp("doubles", doubles) << boost::make_nvp("ts", ts) << boost::make_nvp("text", text)
+       << boost::make_nvp("vec", vec);
+    measured = oa.digest();
+  }
+  EXPECT_EQ(DigestSink::digest(first.str().data(), first.str().size()), digestOnly.digest());
+  EXPECT_EQ(measured, digestOnly.digest());
+  EXPECT_EQ(first.str().size(), digestOnly.size());
+
+  // Forwarding sink: the bytes reach the target, and any change gives another digest.
+  std::string forwarded;
+  StringSink target{forwarded};
+  DigestSink digest{target};
+  vec[42] = NestedBoolObjects(true, true, true);
+  {
+    boost::archive::json_oarchive oa{digest, boost::archive::json_canonical};
+    oa << boost::make_nvp("text", text) << boost::make_nvp("doubles", doubles) << boost::make_nvp("ts", ts)
+       << boost::make_nvp("vec", vec);
+  }
+  EXPECT_EQ(DigestSink::digest(forwarded.data(), forwarded.size()), digest.digest());
+  EXPECT_NE(digestOnly.digest(), digest.digest());
+
+  std::stringstream is(forwarded);
+  boost::archive::json_iarchive ia{is};
+  std::vector<NestedBoolObjects> loaded;
+  TestStruct loaded_ts;
+  ia >> boost::make_nvp("ts", loaded_ts) >> boost::make_nvp("vec", loaded);
+  EXPECT_EQ(vec, loaded);
+  EXPECT_EQ(ts, loaded_ts);
+}
+
+TEST_F(BoostSerializationJsonTest, Serialize_MergePatch) {
+  TestStruct ts{1, 2, 3, 4};
+  std::vector<int> ints(1000, 7);
+  std::string text = "unchanged";
+  std::vector<NestedBoolObjects> vec(10);
+
+  std::stringstream previous;
+  {
+    boost::archive::json_oarchive oa{previous};
+    oa << boost::make_nvp("text", text) << boost::make_nvp("ts", ts) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("vec", vec) << boost::make_nvp("old", text);
+  }
+  ts.b = 20;
+  vec[3] = NestedBoolObjects(false, true, true);
+  std::stringstream current;
+  {
+    boost::archive::json_oarchive oa{current};
+    oa << boost::make_nvp("text", text) << boost::make_nvp("ts", ts) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("vec", vec);
+  }
+  std::stringstream patch;
+  {
+    boost::archive::json_oarchive oa{patch};
+    oa.set_baseline(JsonDocument::parse(previous));
+    oa << boost::make_nvp("text", text) << boost::make_nvp("ts", ts) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("vec", vec);
+  }
+  GTEST_COUT << "Document " << current.str().size() << " bytes, patch " << patch.str().size() << " bytes"
+             << GTEST_ENDL;
+
+  const boost::json::value jpatch = boost::json::parse(patch.str());
+  ASSERT_TRUE(jpatch.is_object());
+  EXPECT_FALSE(jpatch.get_object().contains("ints"));
+  EXPECT_FALSE(jpatch.get_object().contains("text"));
+  EXPECT_TRUE(jpatch.get_object().contains("vec"));
+  const boost::json::object &patched_ts = jpatch.get_object().if_contains("ts")->get_object();
+  EXPECT_EQ(boost::json::value(20), *patched_ts.if_contains("b"));
+  EXPECT_FALSE(patched_ts.contains("a"));
+  EXPECT_TRUE(jpatch.get_object().if_contains("old")->is_null());
+
+  // RFC 7386 application of the patch to the previous document gives the current one.
+  std::function<void(boost::json::value &, const boost::json::value &)> apply = [&](boost::json::value &target,
+                                                                                    const boost::json::value &p) {
+    if (!p.is_object()) {
+      target = p;
+      return;
+    }
+    if (!target.is_object()) {
+      target = boost::json::object();
+    }
+    for (auto const &member : p.get_object()) {
+      if (member.value().is_null()) {
+        target.get_object().erase(member.key());
+      } else {
+        apply(target.get_object()[member.key()], member.value());
+      }
+    }
+  };
+  boost::json::value merged = boost::json::parse(previous.str());
+  apply(merged, jpatch);
+  EXPECT_EQ(boost::json::parse(current.str()), merged);
+
+  boost::archive::json_oarchive oa{patch, boost::archive::json_string_table};
+  ASSERT_THROW(oa.set_baseline(boost::json::value()), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_MergePatch) {
+  TestStruct ts{1, 2, 3, 4};
+  std::vector<int> ints(1000, 7);
+  std::string text = "unchanged";
+  std::vector<NestedBoolObjects> vec(10);
+  std::string old = "removed";
+
+  std::stringstream previous;
+  {
+    boost::archive::json_oarchive oa{previous};
+    oa << boost::make_nvp("text", text) << boost::make_nvp("ts", ts) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("vec", vec) << boost::make_nvp("old", old);
+  }
+  // Receiving side: live copies of the previous state.
+  TestStruct live_ts = ts;
+  std::vector<int> live_ints = ints;
+  std::string live_text = text;
+  std::vector<NestedBoolObjects> live_vec = vec;
+  std::string live_old = old;
+
+  ts.b = 20;
+  vec[3] = NestedBoolObjects(false, true, true);
+  vec.pop_back();
+  std::stringstream patch;
+  {
+    boost::archive::json_oarchive oa{patch};
+    oa.set_baseline(JsonDocument::parse(previous));
+    oa << boost::make_nvp("text", text) << boost::make_nvp("ts", ts) << boost::make_nvp("ints", ints)
+       << boost::make_nvp("vec", vec);
+  }
+
+  // Live values differing from the baseline show which members are left untouched.
+  live_ints[0] = -1;
+  const NestedBoolObjects *storage = live_vec.data();
+  {
+    boost::archive::json_iarchive ia{patch, boost::archive::json_merge_patch};
+    ia >> boost::make_nvp("text", live_text) >> boost::make_nvp("ts", live_ts) >> boost::make_nvp("ints", live_ints) >>
+        boost::make_nvp("vec", live_vec) >> boost::make_nvp("old", live_old);
+  }
+  EXPECT_EQ(text, live_text);
+  EXPECT_EQ(ts, live_ts);
+  EXPECT_EQ(-1, live_ints[0]);
+  EXPECT_EQ(ints.size(), live_ints.size());
+  EXPECT_EQ(vec, live_vec);
+  EXPECT_EQ(storage, live_vec.data());
+  EXPECT_TRUE(live_old.empty());
+
+  // Without the flag, the patch is not a whole document.
+  std::stringstream is(patch.str());
+  boost::archive::json_iarchive ia{is};
+  ASSERT_THROW(ia >> boost::make_nvp("text", live_text), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_MergePatchRootObject) {
+  // A first top-level class object is saved into the root object itself.
+  TestStruct ts{1, 2, 3, 4};
+  std::stringstream previous;
+  {
+    boost::archive::json_oarchive oa{previous};
+    oa << boost::make_nvp("ts", ts);
+  }
+  for (int b : {2, 20}) {
+    TestStruct changed{1, b, 3, 4};
+    std::stringstream baseline(previous.str());
+    std::stringstream patch;
+    {
+      boost::archive::json_oarchive oa{patch};
+      oa.set_baseline(JsonDocument::parse(baseline));
+      oa << boost::make_nvp("ts", changed);
+    }
+    TestStruct live_ts = ts;
+    boost::archive::json_iarchive ia{patch, boost::archive::json_merge_patch};
+    ia >> boost::make_nvp("ts", live_ts);
+    EXPECT_EQ(changed, live_ts);
+  }
+
+  // A deleted member is reset, unless its type cannot be.
+  std::stringstream deleted(R"({"text":"kept","ptr":null})");
+  boost::archive::json_iarchive ia{deleted, boost::archive::json_merge_patch};
+  std::string text;
+  TestStruct *ptr = nullptr;
+  ia >> boost::make_nvp("text", text);
+  EXPECT_EQ("kept", text);
+  ASSERT_THROW(ia >> boost::make_nvp("ptr", ptr), std::runtime_error);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_ContainerReuse) {
+  std::vector<TestStruct> vec;
+  for (int i = 0; i < 100; i++) {
+    vec.push_back(TestStruct{i, i + 1, i + 2, i + 3});
+  }
+  std::array<TestStruct, 3> arr{TestStruct{1, 2, 3, 4}, TestStruct{5, 6, 7, 8}, TestStruct{9, 10, 11, 12}};
+  std::map<std::string, int> map{{"one", 1}, {"two", 2}, {"three", 3}};
+  std::unordered_map<std::string, std::vector<int>> umap{{"a", {1, 2}}, {"b", {}}};
+
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("arr", arr) << boost::make_nvp("map", map)
+       << boost::make_nvp("umap", umap);
+  }
+
+  // Populated targets: elements are reused (no reallocation), stale content is replaced.
+  std::vector<TestStruct> loaded_vec(150, TestStruct{-1, -1, -1, -1});
+  const TestStruct *storage = loaded_vec.data();
+  std::array<TestStruct, 3> loaded_arr{};
+  std::map<std::string, int> loaded_map{{"stale", 0}, {"one", 10}};
+  std::unordered_map<std::string, std::vector<int>> loaded_umap{{"stale", {0}}};
+  {
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is};
+    ia >> boost::make_nvp("vec", loaded_vec) >> boost::make_nvp("arr", loaded_arr) >> boost::make_nvp("map", loaded_map) >>
+        boost::make_nvp("umap", loaded_umap);
+  }
+  EXPECT_EQ(vec, loaded_vec);
+  EXPECT_EQ(storage, loaded_vec.data());
+  EXPECT_EQ(arr, loaded_arr);
+  EXPECT_EQ(map, loaded_map);
+  EXPECT_EQ(umap, loaded_umap);
+
+  // Empty target: reserved once, to the exact size.
+  std::vector<TestStruct> fresh;
+  {
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is};
+    ia >> boost::make_nvp("vec", fresh);
+  }
+  EXPECT_EQ(vec, fresh);
+  EXPECT_EQ(vec.size(), fresh.capacity());
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_ContainerReuseTracked) {
+  std::vector<BoolsObject> vec;
+  for (int i = 0; i < 10; i++) {
+    vec.emplace_back("booboo_" + std::to_string(i), i % 2, i % 3);
+  }
+  BoolsObject *ptr = &vec[1];
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa << boost::make_nvp("vec", vec) << boost::make_nvp("ptr", ptr);
+  }
+
+  // Shorter populated target: reused elements are loaded after the storage grew, so the pointer loaded after them
+  // refers to the element in its final storage.
+  std::vector<BoolsObject> loaded_vec(2);
+  loaded_vec.shrink_to_fit();
+  BoolsObject *loaded_ptr = nullptr;
+  std::stringstream is(ss.str());
+  boost::archive::json_iarchive ia{is};
+  ia >> boost::make_nvp("vec", loaded_vec) >> boost::make_nvp("ptr", loaded_ptr);
+  EXPECT_EQ(vec, loaded_vec);
+  EXPECT_EQ(&loaded_vec[1], loaded_ptr);
+}
+
+TEST_F(BoostSerializationJsonTest, Deserialize_StringTargets) {
+  std::string label = "a label long enough to be allocated";
+  std::string_view view = label;
+  std::string nul("with\0nul", 8);
+  std::vector<std::string> labels(50, label);
+  std::vector<std::string_view> views(3, view);
+
+  for (unsigned int flags : {0u, static_cast<unsigned int>(boost::archive::json_string_table)}) {
+    std::stringstream ss;
+    {
+      boost::archive::json_oarchive oa{ss, flags};
+      oa << boost::make_nvp("view", view) << boost::make_nvp("nul", nul) << boost::make_nvp("labels", labels)
+         << boost::make_nvp("views", views) << boost::make_nvp("chars", label);
+    }
+
+    std::stringstream is(ss.str());
+    boost::archive::json_iarchive ia{is, flags};
+    // Populated targets: loaded in place, reusing their capacity.
+    std::string loaded_view(64, 'x');
+    const char *storage = loaded_view.data();
+    std::string loaded_nul;
+    std::vector<std::string> loaded_labels(50, std::string(64, 'x'));
+    const char *label_storage = loaded_labels[10].data();
+    std::vector<std::string_view> loaded_views;
+    char chars[64];
+    ia >> boost::make_nvp("view", loaded_view) >> boost::make_nvp("nul", loaded_nul) >>
+        boost::make_nvp("labels", loaded_labels) >> boost::make_nvp("views", loaded_views) >>
+        boost::make_nvp("chars", chars);
+    EXPECT_EQ(label, loaded_view);
+    EXPECT_EQ(storage, loaded_view.data());
+    EXPECT_EQ(nul, loaded_nul);
+    EXPECT_EQ(labels, loaded_labels);
+    EXPECT_EQ(label_storage, loaded_labels[10].data());
+    EXPECT_EQ(views, loaded_views);
+    EXPECT_EQ(label, std::string(chars));
+  }
+
+  // Views of the loaded document.
+  {
+    std::stringstream ss;
+    {
+      boost::archive::json_oarchive oa{ss};
+      oa << boost::make_nvp("view", view);
+    }
+    auto document = JsonDocument::parse(ss);
+    boost::archive::json_iarchive ia{document};
+    std::string_view loaded;
+    ia >> boost::make_nvp("view", loaded);
+    EXPECT_EQ(view, loaded);
+    EXPECT_EQ(document->find("/view")->get_string().data(), loaded.data());
+  }
+
+  // Columnar rows, loaded sequentially and on worker threads: views of the document too.
+  std::vector<LabelView> rows;
+  for (size_t i = 0; i < labels.size(); i++) {
+    labels[i] += std::to_string(i);
+    rows.push_back({labels[i], static_cast<int>(i)});
+  }
+  for (unsigned int flags : {0u, static_cast<unsigned int>(boost::archive::json_parallel)}) {
+    std::stringstream ss;
+    {
+      boost::archive::json_oarchive oa{ss, boost::archive::json_columnar};
+      oa << boost::make_nvp("rows", rows);
+    }
+    EXPECT_NE(ss.str().find("\"columns\""), std::string::npos);
+    boost::archive::json_iarchive ia{ss, flags};
+    ia.set_parallel_threshold(2);
+    std::vector<LabelView> loaded_rows;
+    ia >> boost::make_nvp("rows", loaded_rows);
+    EXPECT_EQ(rows, loaded_rows);
+  }
+
+  // Char buffers: bounded copy.
+  std::stringstream ss;
+  {
+    boost::archive::json_oarchive oa{ss};
+    oa << boost::make_nvp("chars", label);
+  }
+  boost::archive::json_iarchive ia{ss};
+  char small[8];
+  ASSERT_THROW(ia >> boost::make_nvp("chars", small), std::runtime_error);
+}
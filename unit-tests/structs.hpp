@@ -1,8 +1,11 @@
 #pragma once
 
 #include <boost/serialization/export.hpp>
+#include <boost/serialization/level.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 
+#include <vector>
+
 class Object {
 protected:
   std::string name = "ObjectName";
@@ -279,6 +282,58 @@ struct TestStruct {
   bool operator==(const TestStruct &rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c && d == rhs.d; }
 };
 
+// Distinct values for large vectors.
+inline TestStruct testStruct(int i) { return TestStruct{i, -i, 2 * i, i % 3}; }
+
+inline std::vector<TestStruct> testStructs(size_t size) {
+  std::vector<TestStruct> vec(size);
+  for (size_t i = 0; i < size; i++) {
+    vec[i] = testStruct(static_cast<int>(i));
+  }
+  return vec;
+}
+
+struct TestStructList {
+  std::vector<TestStruct> list;
+
+  template <typename ArchiveT> inline void serialize(ArchiveT &ar, [[maybe_unused]] const unsigned int file_version) {
+    ar &BOOST_SERIALIZATION_NVP(list);
+  }
+
+  bool operator==(const TestStructList &rhs) const { return list == rhs.list; }
+};
+
+struct FailingStruct {
+  int a;
+
+  template <typename ArchiveT> inline void serialize(ArchiveT &ar, [[maybe_unused]] const unsigned int file_version) {
+    ar &BOOST_SERIALIZATION_NVP(a);
+    if (a < 0) {
+      throw std::runtime_error("Negative value !");
+    }
+  }
+};
+
+struct LabelView {
+  std::string_view label;
+  int id;
+
+  template <typename ArchiveT> inline void serialize(ArchiveT &ar, [[maybe_unused]] const unsigned int file_version) {
+    ar &BOOST_SERIALIZATION_NVP(label);
+    ar &BOOST_SERIALIZATION_NVP(id);
+  }
+
+  bool operator==(const LabelView &rhs) const { return label == rhs.label && id == rhs.id; }
+};
+
+struct EmptyObject {
+  template <typename ArchiveT> inline void serialize([[maybe_unused]] ArchiveT &ar, [[maybe_unused]] const unsigned int file_version) {}
+
+  bool operator==(const EmptyObject &) const { return true; }
+};
+
+BOOST_CLASS_IMPLEMENTATION(EmptyObject, boost::serialization::object_serializable)
+
 class ObjectWithStruct {
 private:
   TestStruct m_struct;